@@ -0,0 +1,30 @@
+#include "DmaIrq.hpp"
+#include "hardware/irq.h"
+
+DmaIrq::Entry DmaIrq::entries[NUM_DMA_CHANNELS];
+
+void DmaIrq::attach(uint channel, Handler handler, void *userData) {
+    // shared, other code may still add handlers of its own to DMA_IRQ_0
+    static bool installed = false;
+    if (!installed) {
+        irq_add_shared_handler(DMA_IRQ_0, dispatch, PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY);
+        irq_set_enabled(DMA_IRQ_0, true);
+        installed = true;
+    }
+    entries[channel] = {handler, userData};
+    dma_channel_set_irq0_enabled(channel, true);
+}
+
+void DmaIrq::detach(uint channel) {
+    dma_channel_set_irq0_enabled(channel, false);
+    entries[channel] = {nullptr, nullptr};
+}
+
+void DmaIrq::dispatch() {
+    for (uint channel = 0; channel < NUM_DMA_CHANNELS; channel++) {
+        const Entry &entry = entries[channel];
+        if (!entry.handler || !dma_channel_get_irq0_status(channel)) continue;
+        dma_channel_acknowledge_irq0(channel);
+        entry.handler(channel, entry.userData);
+    }
+}
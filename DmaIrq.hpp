@@ -0,0 +1,30 @@
+#ifndef DMA_IRQ_H
+#define DMA_IRQ_H
+
+#include "pico/types.h"
+#include "hardware/dma.h"
+
+// One DMA_IRQ_0 handler shared by everything waiting on DMA transfers, eg. the display, LED strips and the buzzer.
+// Users attach a callback to the channel they claimed instead of installing a handler of their own.
+class DmaIrq {
+    public:
+        // Called from interrupt once a transfer of the channel finished, the interrupt is already acknowledged
+        typedef void (*Handler)(uint channel, void *userData);
+
+        // Installs the shared handler on first use and enables interrupt 0 of the channel
+        static void attach(uint channel, Handler handler, void *userData);
+        // Disables interrupt 0 of the channel and forgets its handler
+        static void detach(uint channel);
+
+    private:
+        struct Entry {
+            Handler handler;
+            void *userData;
+        };
+
+        static Entry entries[NUM_DMA_CHANNELS];
+
+        static void dispatch();
+};
+
+#endif
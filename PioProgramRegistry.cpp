@@ -0,0 +1,36 @@
+#include "PioProgramRegistry.hpp"
+#include "pico/platform.h"
+
+PioProgramRegistry::Entry PioProgramRegistry::entries[PIO_PROGRAM_REGISTRY_SIZE];
+
+uint PioProgramRegistry::acquire(PIO pio, const pio_program_t *program) {
+    Entry *free = nullptr;
+    for (Entry &entry : entries) {
+        if (entry.users > 0 && entry.pio == pio && entry.program == program) {
+            entry.users++;
+            return entry.offset;
+        }
+        if (entry.users == 0 && !free) {
+            free = &entry;
+        }
+    }
+    if (!free) {
+        panic("PIO program registry full");
+    }
+    free->pio = pio;
+    free->program = program;
+    free->offset = pio_add_program(pio, program);
+    free->users = 1;
+    return free->offset;
+}
+
+void PioProgramRegistry::release(PIO pio, const pio_program_t *program) {
+    for (Entry &entry : entries) {
+        if (entry.users > 0 && entry.pio == pio && entry.program == program) {
+            if (--entry.users == 0) {
+                pio_remove_program(pio, program, entry.offset);
+            }
+            return;
+        }
+    }
+}
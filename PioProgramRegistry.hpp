@@ -0,0 +1,30 @@
+#ifndef PIO_PROGRAM_REGISTRY_H
+#define PIO_PROGRAM_REGISTRY_H
+
+#include "pico/types.h"
+#include "hardware/pio.h"
+
+// Most different programs loaded at the same time, over all PIO blocks
+#define PIO_PROGRAM_REGISTRY_SIZE 8
+
+// Keeps every PIO program loaded only once per PIO block, however many state machines run it.
+// The program is removed again when its last user releases it.
+class PioProgramRegistry {
+    public:
+        // Loads program into pio unless it is already there and returns its offset.
+        // Panics when the program does not fit, same as pio_add_program.
+        static uint acquire(PIO pio, const pio_program_t *program);
+        static void release(PIO pio, const pio_program_t *program);
+
+    private:
+        struct Entry {
+            PIO pio;
+            const pio_program_t *program;
+            uint offset;
+            uint users;
+        };
+
+        static Entry entries[PIO_PROGRAM_REGISTRY_SIZE];
+};
+
+#endif
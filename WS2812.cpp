@@ -1,7 +1,10 @@
 // https://github.com/ForsakenNGS/Pico_WS2812
 
+#include <string.h>
 #include "WS2812.hpp"
 #include "WS2812.pio.h"
+#include "PioProgramRegistry.hpp"
+#include "hardware/dma.h"
 
 //#define DEBUG
 
@@ -9,78 +12,151 @@
 #include <stdio.h>
 #endif
 
+static constexpr std::array<uint8_t, 256> makeGammaTable() {
+    std::array<uint8_t, 256> table{};
+    for (uint level = 0; level < 256; level++) {
+        table[level] = WS2812::gamma(level);
+    }
+    return table;
+}
+
+const std::array<uint8_t, 256> WS2812::gammaTable = makeGammaTable();
+
+WS2812::WS2812(uint pin, uint length, PIO pio, DataFormat format) {
+    initialize(pin, length, pio, -1, format);
+}
+
 WS2812::WS2812(uint pin, uint length, PIO pio, uint sm)  {
     initialize(pin, length, pio, sm, NONE, GREEN, RED, BLUE);
 }
 
 WS2812::WS2812(uint pin, uint length, PIO pio, uint sm, DataFormat format) {
-    switch (format) {
-        case FORMAT_RGB:
-            initialize(pin, length, pio, sm, NONE, RED, GREEN, BLUE);
-            break;
-        case FORMAT_GRB:
-            initialize(pin, length, pio, sm, NONE, GREEN, RED, BLUE);
-            break;
-        case FORMAT_WRGB:
-            initialize(pin, length, pio, sm, WHITE, RED, GREEN, BLUE);
-            break;
-    }
+    initialize(pin, length, pio, sm, format);
 }
 
 WS2812::WS2812(uint pin, uint length, PIO pio, uint sm, DataByte b1, DataByte b2, DataByte b3) {
-    initialize(pin, length, pio, sm, b1, b1, b2, b3);
+    initialize(pin, length, pio, sm, NONE, b1, b2, b3);
 }
 
 WS2812::WS2812(uint pin, uint length, PIO pio, uint sm, DataByte b1, DataByte b2, DataByte b3, DataByte b4) {
     initialize(pin, length, pio, sm, b1, b2, b3, b4);
 }
 
+WS2812::WS2812(uint pin, uint length, PIO pio, int sm, DataFormat format, uint32_t *colors, uint32_t *data, uint32_t *txData) {
+    initialize(pin, length, pio, sm, format, colors, data, txData);
+}
+
 WS2812::~WS2812() {
-    
+    waitForShow();
+    dma_channel_unclaim(dmaChannel);
+    pio_sm_set_enabled(pio, sm, false);
+    pio_sm_unclaim(pio, sm);
+    PioProgramRegistry::release(pio, &ws2812_program);
+    if (ownsData) {
+        delete[] colors;
+        delete[] data;
+        delete[] txData;
+    }
+}
+
+void WS2812::initialize(uint pin, uint length, PIO pio, int sm, DataFormat format, uint32_t *colors, uint32_t *data, uint32_t *txData) {
+    switch (format) {
+        case FORMAT_RGB:
+            initialize(pin, length, pio, sm, NONE, RED, GREEN, BLUE, colors, data, txData);
+            break;
+        case FORMAT_GRB:
+            initialize(pin, length, pio, sm, NONE, GREEN, RED, BLUE, colors, data, txData);
+            break;
+        case FORMAT_WRGB:
+            initialize(pin, length, pio, sm, WHITE, RED, GREEN, BLUE, colors, data, txData);
+            break;
+    }
 }
 
-void WS2812::initialize(uint pin, uint length, PIO pio, uint sm, DataByte b1, DataByte b2, DataByte b3, DataByte b4) {
+void WS2812::initialize(uint pin, uint length, PIO pio, int sm, DataByte b1, DataByte b2, DataByte b3, DataByte b4, uint32_t *colors, uint32_t *data, uint32_t *txData) {
     this->pin = pin;
     this->length = length;
     this->pio = pio;
-    this->sm = sm;
-    this->data = new uint32_t[length];
-    this->bytes[0] = b1;
-    this->bytes[1] = b2;
-    this->bytes[2] = b3;
-    this->bytes[3] = b4;
-    uint offset = pio_add_program(pio, &ws2812_program);
-    uint bits = (b1 == NONE ? 24 : 32);
+    // claiming panics when the state machine is taken, two strips never share one
+    if (sm < 0) {
+        this->sm = pio_claim_unused_sm(pio, true);
+    } else {
+        pio_sm_claim(pio, sm);
+        this->sm = sm;
+    }
+    this->ownsData = (data == nullptr);
+    this->colors = ownsData ? new uint32_t[length]() : colors;
+    this->data = ownsData ? new uint32_t[length] : data;
+    this->txData = ownsData ? new uint32_t[length] : txData;
+    this->txValid = false;
+    this->busy = false;
+    this->showCallback = nullptr;
+    this->showCallbackData = nullptr;
+    this->brightness = 255;
+    this->gammaCorrection = true;
+    updateLevels();
+    // NONE only makes sense as first byte, it drops to 24 bit words
+    DataByte order[4] = { b1, b2, b3, b4 };
+    this->byteCount = 0;
+    for (uint b = (b1 == NONE ? 1 : 0); b < 4; b++) {
+        this->shifts[byteCount++] = (order[b] == NONE ? 32 : (order[b] - 1) * 8);
+    }
+    // strips on the same PIO block share one copy of the program
+    uint offset = PioProgramRegistry::acquire(pio, &ws2812_program);
+    this->bits = byteCount * 8;
     #ifdef DEBUG
-    printf("WS2812 / Initializing SM %u with offset %X at pin %u and %u data bits...\n", sm, offset, pin, bits);
+    printf("WS2812 / Initializing SM %u with offset %X at pin %u and %u data bits...\n", this->sm, offset, pin, bits);
     #endif
-    ws2812_program_init(pio, sm, offset, pin, 800000, bits);
+    ws2812_program_init(pio, this->sm, offset, pin, 800000, bits);
+
+    // DMA feeds whole words to the state machine, paced by its TX FIFO
+    dmaChannel = dma_claim_unused_channel(true);
+    dma_channel_config config = dma_channel_get_default_config(dmaChannel);
+    channel_config_set_transfer_data_size(&config, DMA_SIZE_32);
+    channel_config_set_read_increment(&config, true);
+    channel_config_set_write_increment(&config, false);
+    channel_config_set_dreq(&config, pio_get_dreq(pio, this->sm, true));
+    dma_channel_configure(dmaChannel, &config, &pio->txf[this->sm], txData, length, false);
 }
 
 uint32_t WS2812::convertData(uint32_t rgbw) {
+    rgbw = correct(rgbw);
+    // words are shifted out MSB first, the first byte goes to the top
     uint32_t result = 0;
-    for (uint b = 0; b < 4; b++) {
-        switch (bytes[b]) {
-            case RED:
-                result |= (rgbw & 0xFF);
-                break;
-            case GREEN:
-                result |= (rgbw & 0xFF00) >> 8;
-                break;
-            case BLUE:
-                result |= (rgbw & 0xFF0000) >> 16;
-                break;
-            case WHITE:
-                result |= (rgbw & 0xFF000000) >> 24;
-                break;
-        }
-        result <<= 8;
+    for (uint b = 0; b < byteCount; b++) {
+        uint32_t value = (shifts[b] < 32) ? (rgbw >> shifts[b]) & 0xFF : 0;
+        result |= value << (24 - b * 8);
     }
     return result;
 }
 
+void WS2812::updateLevels() {
+    for (uint level = 0; level < 256; level++) {
+        uint corrected = gammaCorrection ? gammaTable[level] : level;
+        levels[level] = corrected * (brightness + 1) >> 8;
+    }
+}
+
+void WS2812::setBrightness(uint8_t brightness) {
+    this->brightness = brightness;
+    updateLevels();
+    for (uint i = 0; i < length; i++) {
+        data[i] = convertData(colors[i]);
+    }
+}
+
+uint8_t WS2812::getBrightness() const {
+    return brightness;
+}
+
+void WS2812::setGammaCorrection(bool enabled) {
+    gammaCorrection = enabled;
+    setBrightness(brightness);
+}
+
 void WS2812::setPixelColor(uint index, uint32_t color) {
     if (index < length) {
+        colors[index] = color;
         data[index] = convertData(color);
     }
 }
@@ -106,19 +182,60 @@ void WS2812::fill(uint32_t color, uint first, uint count) {
     if (last > length) {
         last = length;
     }
-    color = convertData(color);
+    uint32_t converted = convertData(color);
     for (uint i = first; i < last; i++) {
-        data[i] = color;
+        colors[i] = color;
+        data[i] = converted;
     }
 }
 
-void WS2812::show() {
+bool WS2812::show() {
+    waitForShow();
+
+    // LEDs keep showing the last latched frame, sending it again changes nothing
+    if (txValid && memcmp(txData, data, length * sizeof(uint32_t)) == 0) {
+        if (showCallback) showCallback(showCallbackData);
+        return true;
+    }
+
+    // The state machine shifts without gaps while DMA keeps its FIFO filled, so the frame takes
+    // 1.25 us per bit. The alarm ending it is reserved before anything goes out, one word more
+    // covers starting DMA after it. Without an alarm busy could never be cleared again.
+    busy = true;
+    if (add_alarm_in_us((length + 1) * bits * 5 / 4 + WS2812_LATCH_US, latchCallback, this, true) < 0) {
+        busy = false;
+        return false;
+    }
+
     #ifdef DEBUG
     for (uint i = 0; i < length; i++) {
         printf("WS2812 / Put data: %08X\n", data[i]);
     }
     #endif
-    for (uint i = 0; i < length; i++) {
-        pio_sm_put_blocking(pio, sm, data[i]);
+    memcpy(txData, data, length * sizeof(uint32_t));
+    txValid = true;
+    dma_channel_transfer_from_buffer_now(dmaChannel, txData, length);
+    return true;
+}
+
+bool WS2812::isBusy() {
+    return busy;
+}
+
+void WS2812::waitForShow() {
+    while (busy) {
+        tight_loop_contents();
     }
+}
+
+void WS2812::setShowCallback(ShowCallback callback, void *userData) {
+    showCallback = callback;
+    showCallbackData = userData;
+}
+
+int64_t WS2812::latchCallback(alarm_id_t id, void *userData) {
+    WS2812 *strip = (WS2812 *) userData;
+    strip->busy = false;
+    if (strip->showCallback) strip->showCallback(strip->showCallbackData);
+    return 0;
 }
\ No newline at end of file
@@ -3,9 +3,15 @@
 #ifndef WS2812_H
 #define WS2812_H
 
+#include <array>
+#include <algorithm>
 #include "pico/types.h"
+#include "pico/time.h"
 #include "hardware/pio.h"
 
+// Low time after the last bit that makes the LEDs latch the frame, in microseconds
+#define WS2812_LATCH_US 50
+
 class WS2812 {
     public:
         enum DataByte {
@@ -21,39 +27,203 @@ class WS2812 {
             FORMAT_WRGB=2
         };
 
+        // Called from interrupt once a frame started by show() is latched
+        typedef void (*ShowCallback)(void *userData);
+
+        // State machine is claimed from the unused ones of pio
+        WS2812(uint pin, uint length, PIO pio, DataFormat format = FORMAT_GRB);
         WS2812(uint pin, uint length, PIO pio, uint sm);
         WS2812(uint pin, uint length, PIO pio, uint sm, DataFormat format);
         WS2812(uint pin, uint length, PIO pio, uint sm, DataByte b1, DataByte b2, DataByte b3);
         WS2812(uint pin, uint length, PIO pio, uint sm, DataByte b1, DataByte b2, DataByte b3, DataByte b4);
         ~WS2812();
 
-        static uint32_t RGB(uint8_t red, uint8_t green, uint8_t blue) {
+        static constexpr uint32_t RGB(uint8_t red, uint8_t green, uint8_t blue) {
             return (uint32_t)(blue) << 16 | (uint32_t)(green) << 8 | (uint32_t)(red);
         };
 
-        static uint32_t RGBW(uint8_t red, uint8_t green, uint8_t blue, uint8_t white) {
+        static constexpr uint32_t RGBW(uint8_t red, uint8_t green, uint8_t blue, uint8_t white) {
             return (uint32_t)(white) << 24 | (uint32_t)(blue) << 16 | (uint32_t)(green) << 8 | (uint32_t)(red);
         }
 
+        // Color from hue 0 - 65535 (red, green at 21845, blue at 43690, back to red), saturation and value 0 - 255.
+        // Integer math only.
+        static constexpr uint32_t HSV(uint16_t hue, uint8_t saturation, uint8_t value) {
+            uint32_t scaled = (uint32_t) hue * 6;
+            uint sector = scaled >> 16;
+            uint32_t fraction = (scaled >> 8) & 0xFF;
+            uint8_t p = div255(value * (255 - saturation));
+            uint8_t q = div255(value * (255 - div255(saturation * fraction)));
+            uint8_t t = div255(value * (255 - div255(saturation * (255 - fraction))));
+            switch (sector) {
+                case 0: return RGB(value, t, p);
+                case 1: return RGB(q, value, p);
+                case 2: return RGB(p, value, t);
+                case 3: return RGB(p, q, value);
+                case 4: return RGB(t, p, value);
+                default: return RGB(value, p, q);
+            }
+        }
+
+        // Level 0 - 255 after gamma correction with a gamma of 2.5, so that steps look evenly spaced
+        static constexpr uint8_t gamma(uint8_t level) {
+            // level^2.5 = level^2 * sqrt(level), sqrt in 8.8 fixed point
+            uint32_t root = 0;
+            while ((root + 1) * (root + 1) <= ((uint32_t) level << 16)) root++;
+            return (uint8_t) (((uint64_t) level * level * root + 255 * 4088 / 2) / (255 * 4088));
+        }
+        // gamma() of every level
+        static const std::array<uint8_t, 256> gammaTable;
+
         void setPixelColor(uint index, uint32_t color);
         void setPixelColor(uint index, uint8_t red, uint8_t green, uint8_t blue);
         void setPixelColor(uint index, uint8_t red, uint8_t green, uint8_t blue, uint8_t white);
         void fill(uint32_t color);
         void fill(uint32_t color, uint first);
         void fill(uint32_t color, uint first, uint count);
-        void show();
+        // Starts sending pixel data through DMA and returns right away.
+        // Waits for the previous frame to be latched first. A frame equal to the last one sent is skipped.
+        // False when no alarm is left to signal the latch, nothing is sent then and show() can be tried again.
+        bool show();
+        // True until the frame started by show() went out and the latch time passed
+        bool isBusy();
+        void waitForShow();
+        void setShowCallback(ShowCallback callback, void *userData = nullptr);
+        // Scales every channel of every pixel, 255 leaves colors as they are.
+        // Pixels already set are converted again right away, show() sends them.
+        void setBrightness(uint8_t brightness);
+        uint8_t getBrightness() const;
+        // Gamma correction of colors is on by default
+        void setGammaCorrection(bool enabled);
+
+    protected:
+        // For subclasses that bring their own pixel storage, all buffers have to hold length words
+        // and outlive the strip. They are not freed by the destructor.
+        // sm < 0 claims any unused state machine
+        WS2812(uint pin, uint length, PIO pio, int sm, DataFormat format, uint32_t *colors, uint32_t *data, uint32_t *txData);
+
+        // Applies gamma correction and brightness to every channel of a RGB(W) color
+        uint32_t correct(uint32_t rgbw) const {
+            return (uint32_t) levels[rgbw >> 24] << 24 | (uint32_t) levels[(rgbw >> 16) & 0xFF] << 16 |
+                   (uint32_t) levels[(rgbw >> 8) & 0xFF] << 8 | levels[rgbw & 0xFF];
+        }
+
+        static constexpr uint8_t div255(uint32_t value) {
+            // exact value / 255 for value up to 255 * 255
+            return (value + 1 + (value >> 8)) >> 8;
+        }
 
     private:
         uint pin;
         uint length;
         PIO pio;
         uint sm;
-        DataByte bytes[4];
+        // Bit position of each sent byte in an RGBW color, in the order they go out
+        uint8_t shifts[4];
+        uint8_t byteCount;
+        // Colors as set, kept to convert them again when brightness changes
+        uint32_t *colors;
         uint32_t *data;
+        // Frame being sent, DMA reads from here so data can change meanwhile
+        uint32_t *txData;
+        // False until the first frame was sent, txData holds nothing before that
+        bool txValid;
+        bool ownsData;
+        uint8_t brightness;
+        bool gammaCorrection;
+        // Channel level after gamma correction and brightness, for each level before
+        uint8_t levels[256];
+        uint bits;
+        int dmaChannel;
+        volatile bool busy;
+        ShowCallback showCallback;
+        void *showCallbackData;
+
+        static int64_t latchCallback(alarm_id_t id, void *userData);
 
-        void initialize(uint pin, uint length, PIO pio, uint sm, DataByte b1, DataByte b2, DataByte b3, DataByte b4);
+        void initialize(uint pin, uint length, PIO pio, int sm, DataFormat format, uint32_t *colors = nullptr, uint32_t *data = nullptr, uint32_t *txData = nullptr);
+        void initialize(uint pin, uint length, PIO pio, int sm, DataByte b1, DataByte b2, DataByte b3, DataByte b4, uint32_t *colors = nullptr, uint32_t *data = nullptr, uint32_t *txData = nullptr);
+        void updateLevels();
         uint32_t convertData(uint32_t rgbw);
 
 };
 
+// Pixel storage of BasicWS2812, a base class so it is there before WS2812 hands it to DMA
+template<uint Length>
+struct WS2812Buffers {
+    std::array<uint32_t, Length> pixelColors{};
+    std::array<uint32_t, Length> pixels{};
+    // Frame being sent, see WS2812::txData
+    std::array<uint32_t, Length> txPixels{};
+};
+
+// Strip with length and byte order fixed at compile time. Pixels live in the object itself and colors
+// are packed with a few constant shifts instead of going through the byte order table.
+// Gamma correction and brightness are applied the same way as by WS2812.
+// Sending, callbacks and effects work the same as with WS2812.
+template<uint Length, WS2812::DataFormat Format = WS2812::FORMAT_GRB>
+class BasicWS2812 : private WS2812Buffers<Length>, public WS2812 {
+    public:
+        static_assert(Length > 0, "strip needs at least one LED");
+
+        // State machine is claimed from the unused ones of pio
+        BasicWS2812(uint pin, PIO pio) : BasicWS2812(pin, pio, -1) {}
+        BasicWS2812(uint pin, PIO pio, int sm) : WS2812(pin, Length, pio, sm, Format, this->pixelColors.data(), this->pixels.data(), this->txPixels.data()) {}
+
+        // RGBW color as made by RGB()/RGBW() to the word sent to the state machine, first byte in the top bits
+        static constexpr uint32_t pack(uint32_t rgbw) {
+            if constexpr (Format == FORMAT_RGB) {
+                return (rgbw & 0xFF) << 24 | (rgbw & 0xFF00) << 8 | (rgbw & 0xFF0000) >> 8;
+            } else if constexpr (Format == FORMAT_GRB) {
+                return (rgbw & 0xFF00) << 16 | (rgbw & 0xFF) << 16 | (rgbw & 0xFF0000) >> 8;
+            } else {
+                return (rgbw & 0xFF000000) | (rgbw & 0xFF) << 16 | (rgbw & 0xFF00) | (rgbw & 0xFF0000) >> 16;
+            }
+        }
+
+        static constexpr uint length() {
+            return Length;
+        }
+
+        void setPixelColor(uint index, uint32_t color) {
+            if (index < Length) {
+                this->pixelColors[index] = color;
+                pixels[index] = pack(correct(color));
+            }
+        }
+
+        void setPixelColor(uint index, uint8_t red, uint8_t green, uint8_t blue) {
+            setPixelColor(index, RGB(red, green, blue));
+        }
+
+        void setPixelColor(uint index, uint8_t red, uint8_t green, uint8_t blue, uint8_t white) {
+            setPixelColor(index, RGBW(red, green, blue, white));
+        }
+
+        void fill(uint32_t color) {
+            fill(color, 0, Length);
+        }
+
+        void fill(uint32_t color, uint first) {
+            fill(color, first, Length);
+        }
+
+        void fill(uint32_t color, uint first, uint count) {
+            if (first >= Length) return;
+            uint last = (count > Length - first) ? Length : first + count;
+            std::fill(this->pixelColors.begin() + first, this->pixelColors.begin() + last, color);
+            std::fill(pixels.begin() + first, pixels.begin() + last, pack(correct(color)));
+        }
+
+    private:
+        using WS2812Buffers<Length>::pixels;
+};
+
+static_assert(BasicWS2812<1, WS2812::FORMAT_RGB>::pack(WS2812::RGB(0x11, 0x22, 0x33)) == 0x11223300, "RGB packing");
+static_assert(BasicWS2812<1, WS2812::FORMAT_GRB>::pack(WS2812::RGB(0x11, 0x22, 0x33)) == 0x22113300, "GRB packing");
+static_assert(WS2812::gamma(0) == 0 && WS2812::gamma(255) == 255 && WS2812::gamma(128) == 46, "gamma table");
+static_assert(WS2812::HSV(0, 255, 255) == WS2812::RGB(255, 0, 0) && WS2812::HSV(21845, 255, 255) == WS2812::RGB(0, 255, 0) &&
+              WS2812::HSV(43690, 255, 255) == WS2812::RGB(0, 0, 255) && WS2812::HSV(1234, 0, 200) == WS2812::RGB(200, 200, 200), "HSV conversion");
+static_assert(BasicWS2812<1, WS2812::FORMAT_WRGB>::pack(WS2812::RGBW(0x11, 0x22, 0x33, 0x44)) == 0x44112233, "WRGB packing");
+
 #endif
\ No newline at end of file
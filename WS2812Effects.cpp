@@ -0,0 +1,102 @@
+#include "WS2812Effects.hpp"
+
+WS2812Effects::WS2812Effects(WS2812 &strip, uint length, uint frameInterval_ms) : strip(strip) {
+    this->length = length;
+    this->frameInterval_ms = frameInterval_ms;
+    this->timerRunning = false;
+    this->effect = OFF;
+    this->color = 0;
+    this->period_ms = 1000;
+    this->start_ms = 0;
+}
+
+WS2812Effects::~WS2812Effects() {
+    stop();
+}
+
+void WS2812Effects::start(Effect effect, uint32_t color, uint period_ms) {
+    // parameters are read by the timer interrupt, so it is stopped while they change
+    if (timerRunning) {
+        cancel_repeating_timer(&timer);
+        timerRunning = false;
+    }
+
+    this->effect = effect;
+    this->color = color;
+    this->period_ms = period_ms ? period_ms : 1;
+    this->start_ms = to_ms_since_boot(get_absolute_time());
+
+    renderFrame(0);
+    strip.show();
+
+    // a solid color never changes, nothing to animate
+    if (effect == OFF || effect == SOLID) return;
+
+    // negative interval keeps frames evenly spaced regardless of how long a frame takes
+    timerRunning = add_repeating_timer_ms(-(int32_t) frameInterval_ms, timerCallback, this, &timer);
+}
+
+void WS2812Effects::stop() {
+    start(OFF, 0);
+}
+
+WS2812Effects::Effect WS2812Effects::getEffect() const {
+    return effect;
+}
+
+void WS2812Effects::renderFrame(uint32_t t_ms) {
+    for (uint i = 0; i < length; i++) {
+        strip.setPixelColor(i, pixelColor(effect, color, period_ms, i, length, t_ms));
+    }
+}
+
+bool WS2812Effects::timerCallback(repeating_timer *timer) {
+    WS2812Effects *effects = (WS2812Effects *) timer->user_data;
+
+    // show() would wait for the latch, which is signalled by a timer interrupt as well,
+    // so a frame still going out just makes this one get dropped
+    if (effects->strip.isBusy()) return true;
+
+    effects->renderFrame(to_ms_since_boot(get_absolute_time()) - effects->start_ms);
+    effects->strip.show();
+    return true;
+}
+
+uint32_t WS2812Effects::scaleColor(uint32_t color, uint level) {
+    // all four channels at once, two at a time so that products do not overlap
+    uint32_t redBlue = ((color & 0x00FF00FF) * level >> 8) & 0x00FF00FF;
+    uint32_t greenWhite = (((color >> 8) & 0x00FF00FF) * level >> 8) & 0x00FF00FF;
+    return redBlue | greenWhite << 8;
+}
+
+uint32_t WS2812Effects::pixelColor(Effect effect, uint32_t color, uint period_ms, uint index, uint length, uint32_t t_ms) {
+    // position within the period as 0 - 255
+    uint32_t phase = (uint64_t) (t_ms % period_ms) * 256 / period_ms;
+
+    switch (effect) {
+        case SOLID:
+            return color;
+        case PULSE: {
+            // triangle wave, 0 - 256 up in first half and back down in the second
+            uint level = phase < 128 ? phase * 2 : (256 - phase) * 2;
+            return scaleColor(color, level);
+        }
+        case CHASE: {
+            if (length == 0) return 0;
+            uint head = (uint64_t) (t_ms % period_ms) * length / period_ms;
+            if (index == head) return color;
+            if (index == (head + length - 1) % length) return scaleColor(color, 64);
+            return 0;
+        }
+        case RAINBOW: {
+            // 16 bit hue, wraps around on its own
+            uint16_t hue = (uint64_t) (t_ms % period_ms) * 65536 / period_ms + (length ? index * 65536 / length : 0);
+            return WS2812::HSV(hue, 255, 255);
+        }
+        case BLINK:
+            return phase < 128 ? color : 0;
+        case OFF:
+            break;
+    }
+    return 0;
+}
@@ -0,0 +1,79 @@
+#ifndef WS2812_EFFECTS_H
+#define WS2812_EFFECTS_H
+
+#include "pico/time.h"
+#include "WS2812.hpp"
+
+// Animations for a WS2812 strip, rendered from a repeating timer interrupt.
+// start() returns right away, frames are computed with integer math only and sent through WS2812::show.
+class WS2812Effects {
+    public:
+        enum Effect {
+            OFF=0,
+            SOLID=1,
+            // fades color in and out, one full fade per period
+            PULSE=2,
+            // single pixel of color with a dimmer tail runs along the strip once per period
+            CHASE=3,
+            // color wheel spread over the strip, rotating once per period, color is ignored
+            RAINBOW=4,
+            // color for first half of period, off for the second
+            BLINK=5
+        };
+
+        WS2812Effects(WS2812 &strip, uint length, uint frameInterval_ms = 20);
+        virtual ~WS2812Effects();
+
+        void start(Effect effect, uint32_t color, uint period_ms = 1000);
+        // Stops the animation and turns the strip off
+        void stop();
+        Effect getEffect() const;
+
+        // Color of a pixel of an effect at time t, depends on nothing else
+        static uint32_t pixelColor(Effect effect, uint32_t color, uint period_ms, uint index, uint length, uint32_t t_ms);
+        // Scales every channel of a RGB(W) color by level / 256
+        static uint32_t scaleColor(uint32_t color, uint level);
+
+    protected:
+        volatile Effect effect;
+        uint32_t color;
+        uint period_ms;
+
+        // Writes frame at time t since start into the strip buffer
+        virtual void renderFrame(uint32_t t_ms);
+
+    private:
+        WS2812 &strip;
+        uint length;
+        uint frameInterval_ms;
+        repeating_timer timer;
+        bool timerRunning;
+        uint32_t start_ms;
+
+        static bool timerCallback(repeating_timer *timer);
+};
+
+// Effects for a strip type with its length fixed at compile time, e.g. BasicWS2812. Pixels are set through
+// the strip type itself, so its packing is used instead of the byte order table of WS2812.
+template<class Strip>
+class BasicWS2812Effects : public WS2812Effects {
+    public:
+        BasicWS2812Effects(Strip &strip, uint frameInterval_ms = 20) : WS2812Effects(strip, Strip::length(), frameInterval_ms), strip(strip) {}
+
+        // The timer has to be gone before renderFrame of this class is
+        ~BasicWS2812Effects() override {
+            stop();
+        }
+
+    protected:
+        void renderFrame(uint32_t t_ms) override {
+            for (uint i = 0; i < Strip::length(); i++) {
+                strip.setPixelColor(i, pixelColor(effect, color, period_ms, i, Strip::length(), t_ms));
+            }
+        }
+
+    private:
+        Strip &strip;
+};
+
+#endif
@@ -0,0 +1,192 @@
+#include "WS2812Parallel.hpp"
+#include "WS2812.pio.h"
+#include "PioProgramRegistry.hpp"
+#include "hardware/dma.h"
+
+WS2812Parallel::WS2812Parallel(uint pinBase, uint strips, uint length, PIO pio, WS2812::DataFormat format) {
+    this->pinBase = pinBase;
+    this->strips = strips > WS2812_PARALLEL_MAX_STRIPS ? WS2812_PARALLEL_MAX_STRIPS : strips;
+    this->length = length;
+    this->pio = pio;
+    this->changed = true;
+    this->brightness = 255;
+    this->gammaCorrection = true;
+    this->busy = false;
+    this->showCallback = nullptr;
+    this->showCallbackData = nullptr;
+    updateLevels();
+
+    switch (format) {
+        case WS2812::FORMAT_RGB:
+            shifts[0] = 0; shifts[1] = 8; shifts[2] = 16;
+            byteCount = 3;
+            break;
+        case WS2812::FORMAT_GRB:
+            shifts[0] = 8; shifts[1] = 0; shifts[2] = 16;
+            byteCount = 3;
+            break;
+        case WS2812::FORMAT_WRGB:
+            shifts[0] = 24; shifts[1] = 0; shifts[2] = 8; shifts[3] = 16;
+            byteCount = 4;
+            break;
+    }
+
+    this->colors = new uint32_t[this->strips * length]();
+    this->txWords = length * byteCount * 2;
+    this->txData = new uint32_t[txWords];
+
+    sm = pio_claim_unused_sm(pio, true);
+    uint offset = PioProgramRegistry::acquire(pio, &ws2812_parallel_program);
+    ws2812_parallel_program_init(pio, sm, offset, pinBase, this->strips, 800000);
+
+    dmaChannel = dma_claim_unused_channel(true);
+    dma_channel_config config = dma_channel_get_default_config(dmaChannel);
+    channel_config_set_transfer_data_size(&config, DMA_SIZE_32);
+    channel_config_set_read_increment(&config, true);
+    channel_config_set_write_increment(&config, false);
+    channel_config_set_dreq(&config, pio_get_dreq(pio, sm, true));
+    dma_channel_configure(dmaChannel, &config, &pio->txf[sm], txData, txWords, false);
+}
+
+WS2812Parallel::~WS2812Parallel() {
+    waitForShow();
+    dma_channel_unclaim(dmaChannel);
+    pio_sm_set_enabled(pio, sm, false);
+    pio_sm_unclaim(pio, sm);
+    PioProgramRegistry::release(pio, &ws2812_parallel_program);
+    delete[] colors;
+    delete[] txData;
+}
+
+void WS2812Parallel::setPixelColor(uint strip, uint index, uint32_t color) {
+    if (strip < strips && index < length) {
+        colors[strip * length + index] = color;
+        changed = true;
+    }
+}
+
+void WS2812Parallel::setPixelColor(uint strip, uint index, uint8_t red, uint8_t green, uint8_t blue) {
+    setPixelColor(strip, index, WS2812::RGB(red, green, blue));
+}
+
+void WS2812Parallel::fill(uint strip, uint32_t color) {
+    if (strip >= strips) return;
+    for (uint i = 0; i < length; i++) {
+        colors[strip * length + i] = color;
+    }
+    changed = true;
+}
+
+void WS2812Parallel::fill(uint32_t color) {
+    for (uint strip = 0; strip < strips; strip++) {
+        fill(strip, color);
+    }
+}
+
+void WS2812Parallel::transpose8(uint32_t low, uint32_t high, uint32_t *out) {
+    // Hacker's Delight 8x8 bit matrix transpose on two 32 bit halves, the M0+ has no fast 64 bit shifts.
+    // Rows are bytes with input 7 at the top of high, so the result has input i in bit i.
+    uint32_t x = high;
+    uint32_t y = low;
+    uint32_t t;
+
+    t = (x ^ (x >> 7)) & 0x00AA00AA;
+    x = x ^ t ^ (t << 7);
+    t = (y ^ (y >> 7)) & 0x00AA00AA;
+    y = y ^ t ^ (t << 7);
+
+    t = (x ^ (x >> 14)) & 0x0000CCCC;
+    x = x ^ t ^ (t << 14);
+    t = (y ^ (y >> 14)) & 0x0000CCCC;
+    y = y ^ t ^ (t << 14);
+
+    t = (x & 0xF0F0F0F0) | ((y >> 4) & 0x0F0F0F0F);
+    y = ((x << 4) & 0xF0F0F0F0) | (y & 0x0F0F0F0F);
+
+    out[0] = t;
+    out[1] = y;
+}
+
+bool WS2812Parallel::show() {
+    waitForShow();
+
+    // LEDs keep showing the last latched frame, sending it again changes nothing
+    if (!changed) {
+        if (showCallback) showCallback(showCallbackData);
+        return true;
+    }
+
+    uint32_t *out = txData;
+    for (uint i = 0; i < length; i++) {
+        for (uint b = 0; b < byteCount; b++) {
+            uint32_t low = 0;
+            uint32_t high = 0;
+            for (uint strip = 0; strip < strips; strip++) {
+                uint32_t level = levels[(colors[strip * length + i] >> shifts[b]) & 0xFF];
+                if (strip < 4) {
+                    low |= level << (strip * 8);
+                } else {
+                    high |= level << ((strip - 4) * 8);
+                }
+            }
+            transpose8(low, high, out);
+            out += 2;
+        }
+    }
+
+    // every word holds 4 bits of each strip, 1.25 us per bit, followed by the latch.
+    // Reserved before anything goes out, see WS2812::show(). The frame stays changed without it.
+    busy = true;
+    if (add_alarm_in_us((txWords + 1) * 4 * 5 / 4 + WS2812_LATCH_US, latchCallback, this, true) < 0) {
+        busy = false;
+        return false;
+    }
+
+    changed = false;
+    dma_channel_transfer_from_buffer_now(dmaChannel, txData, txWords);
+    return true;
+}
+
+bool WS2812Parallel::isBusy() {
+    return busy;
+}
+
+void WS2812Parallel::waitForShow() {
+    while (busy) {
+        tight_loop_contents();
+    }
+}
+
+void WS2812Parallel::setShowCallback(WS2812::ShowCallback callback, void *userData) {
+    showCallback = callback;
+    showCallbackData = userData;
+}
+
+void WS2812Parallel::updateLevels() {
+    for (uint level = 0; level < 256; level++) {
+        uint corrected = gammaCorrection ? WS2812::gammaTable[level] : level;
+        levels[level] = corrected * (brightness + 1) >> 8;
+    }
+    changed = true;
+}
+
+void WS2812Parallel::setBrightness(uint8_t brightness) {
+    this->brightness = brightness;
+    updateLevels();
+}
+
+uint8_t WS2812Parallel::getBrightness() const {
+    return brightness;
+}
+
+void WS2812Parallel::setGammaCorrection(bool enabled) {
+    gammaCorrection = enabled;
+    updateLevels();
+}
+
+int64_t WS2812Parallel::latchCallback(alarm_id_t id, void *userData) {
+    WS2812Parallel *strips = (WS2812Parallel *) userData;
+    strips->busy = false;
+    if (strips->showCallback) strips->showCallback(strips->showCallbackData);
+    return 0;
+}
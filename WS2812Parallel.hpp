@@ -0,0 +1,67 @@
+#ifndef WS2812_PARALLEL_H
+#define WS2812_PARALLEL_H
+
+#include "WS2812.hpp"
+
+#define WS2812_PARALLEL_MAX_STRIPS 8
+
+// Up to 8 strips on consecutive pins driven by a single state machine.
+// Every bit goes out to all strips at once, so a frame takes as long as one strip of the same length,
+// however many strips there are. Pixel colors are bit transposed into the DMA buffer by show().
+// Colors, gamma correction and brightness work the same as with WS2812.
+class WS2812Parallel {
+    public:
+        // Strips are on pins pinBase to pinBase + strips - 1, each up to length LEDs long.
+        // State machine is claimed from the unused ones of pio.
+        WS2812Parallel(uint pinBase, uint strips, uint length, PIO pio, WS2812::DataFormat format = WS2812::FORMAT_GRB);
+        ~WS2812Parallel();
+
+        void setPixelColor(uint strip, uint index, uint32_t color);
+        void setPixelColor(uint strip, uint index, uint8_t red, uint8_t green, uint8_t blue);
+        void fill(uint strip, uint32_t color);
+        // Sets every pixel of every strip
+        void fill(uint32_t color);
+        // Starts sending all strips through DMA and returns right away.
+        // Waits for the previous frame to be latched first. Nothing is sent when no pixel changed since.
+        // False when no alarm is left to signal the latch, the frame is kept for the next show() then.
+        bool show();
+        bool isBusy();
+        void waitForShow();
+        void setShowCallback(WS2812::ShowCallback callback, void *userData = nullptr);
+        void setBrightness(uint8_t brightness);
+        uint8_t getBrightness() const;
+        void setGammaCorrection(bool enabled);
+
+        // Transposes 8 bytes, byte s of the result holds bit 7 - s of every input byte, bit i for inputs[i].
+        // Inputs 0 - 3 are packed into low, 4 - 7 into high, byte 0 of the result is the top byte of the first word.
+        static void transpose8(uint32_t low, uint32_t high, uint32_t *out);
+
+    private:
+        uint pinBase;
+        uint strips;
+        uint length;
+        PIO pio;
+        uint sm;
+        // Bit position of each sent byte in an RGBW color, in the order they go out
+        uint8_t shifts[4];
+        uint8_t byteCount;
+        // Colors as set, strip after strip
+        uint32_t *colors;
+        // Transposed frame, two words for every byte of a pixel
+        uint32_t *txData;
+        uint txWords;
+        // Set when colors or levels changed since the last frame was sent
+        bool changed;
+        uint8_t brightness;
+        bool gammaCorrection;
+        uint8_t levels[256];
+        int dmaChannel;
+        volatile bool busy;
+        WS2812::ShowCallback showCallback;
+        void *showCallbackData;
+
+        void updateLevels();
+        static int64_t latchCallback(alarm_id_t id, void *userData);
+};
+
+#endif
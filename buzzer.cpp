@@ -2,23 +2,108 @@
 // https://forums.raspberrypi.com/viewtopic.php?t=310320#p1857472 (converted to C++ and OOP design)
 
 #include "buzzer.h"
+#include "hardware/clocks.h"
+#include "hardware/dma.h"
+#include "buzzer.pio.h"
+#include "PioProgramRegistry.hpp"
+#include "DmaIrq.hpp"
 
-Buzzer::Buzzer(uint gpio) : pin(gpio)
+Buzzer::Buzzer(uint gpio, PIO pio) : pin(gpio), pio(pio)
 {
     current_note = nullptr;
-    delay_off = 0;
+    current_step = nullptr;
+    steps_end = nullptr;
+    current_packed = nullptr;
+    packed_end = nullptr;
+    tones = nullptr;
+    tone_on = false;
+    current_alarm = 0;
     whole_note_duration = 0;
+    sys_clock = clock_get_hz(clk_sys);
     tempo = 0;
     is_done = false;
+    envelope = FullEnvelope;
+    duty = volumeDuty(envelope.volume);
+    tone_level = 0;
+    attack_us = 0;
+    release_us = 0;
+    tone_left_us = 0;
+    level = 0;
+    attack_step = 0;
+    release_step = 0;
+    streaming = false;
+    stream_playing = false;
+    stream_sent = false;
+    sm = 0;
+    program_offset = 0;
+    dma_channel = -1;
+    stream_words = nullptr;
     gpio_set_function(pin, GPIO_FUNC_PWM);
     slice_num = pwm_gpio_to_slice_num(pin);
+
+    // slice keeps running silently, notes only change its registers
+    pwm_config cfg = pwm_get_default_config();
+    pwm_init(slice_num, &cfg, true);
+    pwm_set_chan_level(slice_num, PWM_CHAN_A, 0);
 }
 
 Buzzer::~Buzzer()
 {
+    setStreaming(false);
     gpio_set_function(pin, GPIO_FUNC_NULL);
 }
 
+void Buzzer::setStreaming(bool enabled)
+{
+    if (enabled == streaming)
+        return;
+    stopMelody();
+
+    if (enabled)
+    {
+        sm = pio_claim_unused_sm(pio, true);
+        program_offset = PioProgramRegistry::acquire(pio, &buzzer_tone_program);
+        stream_words = new uint32_t[BUZZER_STREAM_MAX_NOTES * 4];
+
+        dma_channel = dma_claim_unused_channel(true);
+        dma_channel_config config = dma_channel_get_default_config(dma_channel);
+        channel_config_set_transfer_data_size(&config, DMA_SIZE_32);
+        channel_config_set_read_increment(&config, true);
+        channel_config_set_write_increment(&config, false);
+        channel_config_set_dreq(&config, pio_get_dreq(pio, sm, true));
+        dma_channel_configure(dma_channel, &config, &pio->txf[sm], stream_words, 0, false);
+        DmaIrq::attach(dma_channel, dmaIrqHandler, this);
+    }
+    else
+    {
+        DmaIrq::detach(dma_channel);
+        dma_channel_unclaim(dma_channel);
+        dma_channel = -1;
+        pio_sm_set_enabled(pio, sm, false);
+        pio_sm_unclaim(pio, sm);
+        PioProgramRegistry::release(pio, &buzzer_tone_program);
+        delete[] stream_words;
+        stream_words = nullptr;
+        gpio_set_function(pin, GPIO_FUNC_PWM);
+    }
+    streaming = enabled;
+}
+
+void Buzzer::setEnvelope(const Envelope &envelope)
+{
+    this->envelope = envelope;
+    duty = volumeDuty(envelope.volume);
+}
+void Buzzer::setVolume(uint8_t volume)
+{
+    envelope.volume = volume;
+    duty = volumeDuty(volume);
+}
+const Envelope &Buzzer::getEnvelope() const
+{
+    return envelope;
+}
+
 void Buzzer::playMelody(const Melody &melody)
 {
     playMelody(melody, 0);
@@ -26,65 +111,163 @@ void Buzzer::playMelody(const Melody &melody)
 void Buzzer::playMelody(const Melody &melody, uint custom_tempo = 0)
 {
     current_note = melody.notes;
+    current_step = nullptr;
+    current_packed = nullptr;
     tempo = (custom_tempo == 0) ? melody.tempo : custom_tempo;
     whole_note_duration = (60000 * 4) / tempo;
-    delay_off = 0;
+    start();
+}
+void Buzzer::playMelody(const MelodySchedule &schedule)
+{
+    current_note = nullptr;
+    current_step = schedule.steps;
+    steps_end = schedule.steps + schedule.length;
+    current_packed = nullptr;
+    start();
+}
+void Buzzer::playMelody(const PackedMelody &melody)
+{
+    current_note = nullptr;
+    current_step = nullptr;
+    current_packed = melody.notes;
+    packed_end = melody.notes + melody.length;
+    tones = melody.tones;
+    whole_note_duration = melody.whole_note_duration;
+    start();
+}
+void Buzzer::start()
+{
+    tone_on = false;
     is_done = false;
+    // the state machine plays every note at one duty, fades need the PWM
+    bool fades = envelope.attack_ms != 0 || envelope.release_ms != 0;
+    if (streaming && !fades && startStream())
+        return;
+    gpio_set_function(pin, GPIO_FUNC_PWM);
     current_alarm = add_alarm_in_us(1000, timer_note_callback_static, this, false);
-    return;
 }
 void Buzzer::stopMelody()
 {
+    if (stream_playing)
+        stopStream();
     cancel_alarm(current_alarm);
     pwm_set_chan_level(slice_num, PWM_CHAN_A, 0);
     current_note = nullptr;
-    delay_off = 0;
+    current_step = nullptr;
+    current_packed = nullptr;
+    tone_on = false;
     is_done = true;
 }
 bool Buzzer::isDone() const
 {
+    // state machine stalls on its empty FIFO once the last note is over
+    if (stream_playing)
+        return stream_sent && (pio->fdebug & (1u << (PIO_FDEBUG_TXSTALL_LSB + sm)));
     return is_done;
 }
 
-void Buzzer::pwm_calc_div_top(pwm_config &cfg, int frequency, int sysClock)
+bool Buzzer::startStream()
 {
-    uint count = sysClock * 16 / frequency;
-    uint div = count / 60000;
-    if (div < 16)
-        div = 16;
-    cfg.div = div;
-    cfg.top = count / div;
+    // keep the position in case the melody turns out too long and is played note by note after all
+    const Note *first_note = current_note;
+    const ToneStep *first_step = current_step;
+    const uint16_t *first_packed = current_packed;
+
+    uint32_t cycles_per_us = sys_clock / 1000000;
+    uint count = 0;
+    while (nextStep())
+    {
+        if (count == BUZZER_STREAM_MAX_NOTES * 4)
+        {
+            current_note = first_note;
+            current_step = first_step;
+            current_packed = first_packed;
+            return false;
+        }
+
+        // same period and duty as the PWM would play
+        uint32_t period = (uint32_t)step.div * (step.top + 1) / 16;
+        uint32_t high = (uint64_t)period * duty >> 16;
+        uint32_t silence = step.off_us;
+        if (step.div != 0 && duty != 0 && period > 7)
+        {
+            uint32_t high_delay = high > 3 ? high - 3 : 0;
+            stream_words[count++] = ((uint64_t)step.on_us * cycles_per_us + period / 2) / period;
+            stream_words[count++] = high_delay;
+            stream_words[count++] = period - 7 - high_delay;
+        }
+        else
+        {
+            stream_words[count++] = 0;
+            stream_words[count++] = 0;
+            stream_words[count++] = 0;
+            silence += step.on_us;
+        }
+        uint32_t silence_cycles = silence * cycles_per_us;
+        stream_words[count++] = silence_cycles > 3 ? silence_cycles - 3 : 0;
+    }
+
+    if (count == 0)
+    {
+        is_done = true;
+        return true;
+    }
+
+    buzzer_tone_program_init(pio, sm, program_offset, pin);
+    stream_sent = false;
+    stream_playing = true;
+    dma_channel_transfer_from_buffer_now(dma_channel, stream_words, count);
+    return true;
 }
 
-uint Buzzer::playTone()
+void Buzzer::stopStream()
 {
-    pwm_config cfg = pwm_get_default_config();
+    dma_channel_set_irq0_enabled(dma_channel, false);
+    dma_channel_abort(dma_channel);
+    dma_channel_acknowledge_irq0(dma_channel);
+    dma_channel_set_irq0_enabled(dma_channel, true);
 
-    if (current_note == nullptr)
-        return 0;
+    // drop the queued notes and leave the pin low
+    pio_sm_set_enabled(pio, sm, false);
+    pio_sm_clear_fifos(pio, sm);
+    pio_sm_restart(pio, sm);
+    pio_sm_exec(pio, sm, pio_encode_set(pio_pins, 0));
+    pio_sm_exec(pio, sm, pio_encode_jmp(program_offset));
+    pio_sm_set_enabled(pio, sm, true);
+    stream_playing = false;
+}
 
-    int duration = current_note->duration;
-    if (duration == 0)
-        return 0;
+void Buzzer::dmaIrqHandler(uint channel, void *user_data)
+{
+    Buzzer *buzzer = static_cast<Buzzer *>(user_data);
 
-    if (duration > 0)
-        duration = whole_note_duration / duration;
-    else
-        duration = (3 * whole_note_duration / (-duration)) / 2;
+    // every note is queued now, a stall from here on means the last one is over
+    buzzer->pio->fdebug = 1u << (PIO_FDEBUG_TXSTALL_LSB + buzzer->sm);
+    buzzer->stream_sent = true;
+}
 
-    if (current_note->frequency == 0)
+bool Buzzer::nextStep()
+{
+    if (current_packed != nullptr)
     {
-        pwm_set_chan_level(slice_num, PWM_CHAN_A, 0);
+        if (current_packed == packed_end)
+            return false;
+        step = decodeNote(*current_packed++, whole_note_duration, tones);
+        return true;
     }
-    else
+
+    if (current_step != nullptr)
     {
-        pwm_calc_div_top(cfg, current_note->frequency, 125000000);
-        pwm_init(slice_num, &cfg, true);
-        pwm_set_chan_level(slice_num, PWM_CHAN_A, cfg.top / 2);
+        if (current_step == steps_end)
+            return false;
+        step = *current_step++;
+        return true;
     }
 
-    delay_off = duration;
-    return duration;
+    if (current_note == nullptr || current_note->duration == 0)
+        return false;
+    step = compileNote(*current_note++, whole_note_duration, sys_clock);
+    return true;
 }
 
 int64_t Buzzer::timer_note_callback_static(alarm_id_t id, void *user_data)
@@ -96,29 +279,78 @@ int64_t Buzzer::timer_note_callback_static(alarm_id_t id, void *user_data)
 
 int64_t Buzzer::timer_note_callback(alarm_id_t id)
 {
-    if (current_note == nullptr || current_note->duration == 0)
-    {
-        is_done = true;
-        return 0; // Done!
-    }
-
-    if (delay_off == 0)
+    if (!tone_on)
     {
-        uint delay_on = playTone();
-        if (delay_on == 0)
+        if (!nextStep() || step.on_us == 0)
         {
             is_done = true;
-            return 0;
+            return 0; // Done!
         }
-        delay_off = delay_on;
-        return 900 * delay_on;
+
+        tone_on = true;
+        // a rest stays silent from the end of the previous note
+        if (step.div == 0)
+        {
+            tone_left_us = 0;
+            return step.on_us;
+        }
+
+        pwm_hw->slice[slice_num].div = step.div;
+        pwm_hw->slice[slice_num].top = step.top;
+        pwm_hw->slice[slice_num].ctr = 0;
+        tone_level = dutyLevel(step.top, duty);
+
+        // fades share the note when it is too short for both
+        attack_us = envelope.attack_ms * 1000;
+        release_us = envelope.release_ms * 1000;
+        if (attack_us + release_us > step.on_us)
+        {
+            attack_us = (uint64_t)attack_us * step.on_us / (attack_us + release_us);
+            release_us = step.on_us - attack_us;
+        }
+        uint32_t full = (uint32_t)tone_level << 16;
+        level = attack_us ? 0 : full;
+        attack_step = attack_us ? full / ((attack_us + BUZZER_ENVELOPE_STEP_US - 1) / BUZZER_ENVELOPE_STEP_US) : 0;
+        release_step = release_us ? full / ((release_us + BUZZER_ENVELOPE_STEP_US - 1) / BUZZER_ENVELOPE_STEP_US) : 0;
+        tone_left_us = step.on_us;
+        return shapeTone();
+    }
+    else if (tone_left_us > 0)
+    {
+        return shapeTone();
     }
     else
     {
         pwm_set_chan_level(slice_num, PWM_CHAN_A, 0);
-        uint delay_off_temp = delay_off;
-        delay_off = 0;
-        current_note++;
-        return 100 * delay_off_temp;
+        tone_on = false;
+        return step.off_us;
+    }
+}
+
+uint32_t Buzzer::shapeTone()
+{
+    uint32_t full = (uint32_t)tone_level << 16;
+    uint32_t elapsed = step.on_us - tone_left_us;
+    uint32_t next;
+    if (elapsed < attack_us)
+    {
+        next = MIN(BUZZER_ENVELOPE_STEP_US, attack_us - elapsed);
+        level = MIN(level + attack_step, full);
+    }
+    else if (tone_left_us > release_us)
+    {
+        // held until the release starts
+        next = tone_left_us - release_us;
+        level = full;
     }
+    else
+    {
+        next = MIN(BUZZER_ENVELOPE_STEP_US, tone_left_us);
+        level -= MIN(level, release_step);
+    }
+
+    // level is double buffered by the slice, it changes at the end of a period without a glitch
+    pwm_set_chan_level(slice_num, PWM_CHAN_A, level >> 16);
+    tone_left_us -= next;
+    return next;
 }
\ No newline at end of file
@@ -3,6 +3,18 @@
 #include "pico/stdlib.h"
 #include "pico/time.h"
 #include "hardware/pwm.h"
+#include "hardware/pio.h"
+
+// Most notes of a melody played by streaming, longer ones are played note by note
+#define BUZZER_STREAM_MAX_NOTES 320
+
+// System clock the compiled melodies are made for
+#ifndef BUZZER_SYS_CLOCK_HZ
+#define BUZZER_SYS_CLOCK_HZ 125000000
+#endif
+
+// Interval the duty is stepped at while a note fades in or out, in us
+#define BUZZER_ENVELOPE_STEP_US 1000
 
 class Note
 {
@@ -17,18 +29,296 @@ struct Melody
     uint tempo;
 };
 
+// A note as PWM register values and timing, ready to be played
+struct ToneStep
+{
+    // PWM clock divider in 8.4 fixed point, 0 for a rest
+    uint16_t div;
+    // PWM wrap value, the tone is sys clock / div / (top + 1)
+    uint16_t top;
+    uint32_t on_us;
+    uint32_t off_us;
+};
+
+struct MelodySchedule
+{
+    const ToneStep *steps;
+    uint16_t length;
+};
+
+// PWM divider in 8.4 fixed point and wrap value of a frequency, both 0 for a rest
+struct PwmTone
+{
+    uint16_t div;
+    uint16_t top;
+};
+
+// How loud notes are played. volume 0 - 255 sets the duty of the square wave, 255 is 50% and as loud as the
+// buzzer gets. Each note fades in over attack_ms and out over release_ms, it keeps its length either way.
+struct Envelope
+{
+    uint8_t volume;
+    uint16_t attack_ms;
+    uint16_t release_ms;
+};
+
+// Full volume with hard note edges, how melodies played before envelopes existed
+constexpr Envelope FullEnvelope = {255, 0, 0};
+
+// Share of a period the output is high in 0.16 fixed point, up to one half at volume 255
+constexpr uint32_t volumeDuty(uint8_t volume)
+{
+    return (uint32_t)volume * 32768 / 255;
+}
+
+// Channel level of a PWM slice wrapping at top that gives the duty
+constexpr uint16_t dutyLevel(uint16_t top, uint32_t duty)
+{
+    return ((uint32_t)top + 1) * duty >> 16;
+}
+
+static_assert(dutyLevel(999, volumeDuty(255)) == 500 && dutyLevel(999, volumeDuty(0)) == 0 &&
+                  dutyLevel(60000, volumeDuty(128)) == 15058,
+              "volume duty");
+
+constexpr PwmTone compileTone(uint16_t frequency, uint32_t sysClock)
+{
+    if (frequency == 0)
+        return {0, 0};
+    // largest top up to 60000 for the best frequency resolution, divider at least 1
+    uint32_t count = (uint64_t)sysClock * 16 / frequency;
+    uint32_t div = count / 60000;
+    if (div < 16)
+        div = 16;
+    return {(uint16_t)div, (uint16_t)(count / div - 1)};
+}
+
+// Frequency a compiled tone plays in Hz, 0 for a rest
+constexpr uint32_t toneFrequency(uint16_t div, uint16_t top, uint32_t sysClock)
+{
+    return div ? (uint64_t)sysClock * 16 / ((uint64_t)div * (top + 1)) : 0;
+}
+
+constexpr ToneStep makeStep(PwmTone tone, uint duration)
+{
+    return {tone.div, tone.top, 900 * duration, 100 * duration};
+}
+
+// Time a note takes including the pause after it, whole_note_duration and result in ms
+constexpr uint noteDuration(const Note &note, uint whole_note_duration)
+{
+    return (note.duration > 0) ? whole_note_duration / note.duration
+                               : (3 * whole_note_duration / (-note.duration)) / 2;
+}
+
+// Converts a note, whole_note_duration is in ms. Usable at compile time.
+constexpr ToneStep compileNote(const Note &note, uint whole_note_duration, uint32_t sysClock)
+{
+    return makeStep(compileTone(note.frequency, sysClock), noteDuration(note, whole_note_duration));
+}
+
+// Time a melody takes to play in ms, up to its terminating note of duration 0 or max_notes notes
+constexpr uint32_t melodyDuration(const Melody &melody, size_t max_notes = SIZE_MAX)
+{
+    uint whole_note_duration = (60000 * 4) / melody.tempo;
+    uint32_t duration = 0;
+    for (size_t i = 0; i < max_notes && melody.notes[i].duration != 0; i++)
+        duration += noteDuration(melody.notes[i], whole_note_duration);
+    return duration;
+}
+
+template <size_t N>
+struct CompiledMelody
+{
+    ToneStep steps[N];
+    uint16_t length;
+    uint32_t duration_us;
+
+    constexpr operator MelodySchedule() const
+    {
+        return {steps, length};
+    }
+};
+
+// Compiles a note array up to its terminating note of duration 0 (or its end) at build time:
+// constexpr auto schedule = compileMelody(notes, tempo);
+template <uint32_t SysClock = BUZZER_SYS_CLOCK_HZ, size_t N>
+constexpr CompiledMelody<N> compileMelody(const Note (&notes)[N], uint tempo)
+{
+    CompiledMelody<N> compiled = {};
+    uint whole_note_duration = (60000 * 4) / tempo;
+    while (compiled.length < N && notes[compiled.length].duration != 0)
+    {
+        ToneStep step = compileNote(notes[compiled.length], whole_note_duration, SysClock);
+        compiled.steps[compiled.length++] = step;
+        compiled.duration_us += step.on_us + step.off_us;
+    }
+    return compiled;
+}
+
+// True when every step of compiled plays the frequency of its note within tolerance_permille
+template <uint32_t SysClock = BUZZER_SYS_CLOCK_HZ, size_t N>
+constexpr bool melodyMatches(const CompiledMelody<N> &compiled, const Note (&notes)[N], uint tolerance_permille = 1)
+{
+    for (uint i = 0; i < compiled.length; i++)
+    {
+        uint32_t expected = notes[i].frequency;
+        uint32_t actual = toneFrequency(compiled.steps[i].div, compiled.steps[i].top, SysClock);
+        uint32_t error = actual > expected ? actual - expected : expected - actual;
+        // compiled frequency is rounded down, allow that 1 Hz on top
+        if (error * 1000 > expected * tolerance_permille + 1000)
+            return false;
+    }
+    return true;
+}
+
+// Packed notes take 2 bytes each: bits 0 - 6 index a tone table, bits 7 - 9 hold the duration as a power of two
+// (0 for a whole note, 3 for an eighth) and bit 10 marks a dotted note. Durations match compileNote.
+#define PACKED_NOTE_INDEX_MASK 0x7F
+#define PACKED_NOTE_LENGTH_SHIFT 7
+#define PACKED_NOTE_DOTTED 0x400
+
+struct PackedMelody
+{
+    const uint16_t *notes;
+    uint16_t length;
+    // in ms
+    uint16_t whole_note_duration;
+    const PwmTone *tones;
+};
+
+template <size_t T>
+struct ToneTable
+{
+    PwmTone tones[T];
+};
+
+// Tone of every frequency of a table, the index of a frequency is the index used by packed notes
+template <uint32_t SysClock = BUZZER_SYS_CLOCK_HZ, size_t T>
+constexpr ToneTable<T> compileTones(const uint16_t (&frequencies)[T])
+{
+    ToneTable<T> table = {};
+    for (size_t i = 0; i < T; i++)
+        table.tones[i] = compileTone(frequencies[i], SysClock);
+    return table;
+}
+
+constexpr ToneStep decodeNote(uint16_t packed, uint whole_note_duration, const PwmTone *tones)
+{
+    uint shift = (packed >> PACKED_NOTE_LENGTH_SHIFT) & 0x7;
+    uint duration = (packed & PACKED_NOTE_DOTTED) ? ((3 * whole_note_duration) >> shift) / 2 : whole_note_duration >> shift;
+    return makeStep(tones[packed & PACKED_NOTE_INDEX_MASK], duration);
+}
+
+template <size_t N>
+struct PackedNotes
+{
+    uint16_t notes[N];
+    uint16_t length;
+    uint16_t whole_note_duration;
+    const PwmTone *tones;
+    // time all notes take to play, in ms
+    uint32_t duration_ms;
+    // false when a note had a frequency missing from the table or a duration that is no power of two
+    bool valid;
+
+    constexpr operator PackedMelody() const
+    {
+        return {notes, length, whole_note_duration, tones};
+    }
+};
+
+// Packs a note array up to its terminating note of duration 0 (or its end) at build time.
+// frequencies and tones have to come from the same table, see compileTones.
+template <size_t N, size_t T>
+constexpr PackedNotes<N> packMelody(const Note (&notes)[N], uint tempo, const uint16_t (&frequencies)[T], const ToneTable<T> &tones)
+{
+    PackedNotes<N> packed = {};
+    packed.whole_note_duration = (60000 * 4) / tempo;
+    packed.tones = tones.tones;
+    packed.valid = T <= PACKED_NOTE_INDEX_MASK + 1;
+    while (packed.length < N && notes[packed.length].duration != 0)
+    {
+        const Note &note = notes[packed.length];
+        uint16_t code = 0;
+        while (code < T && frequencies[code] != note.frequency)
+            code++;
+        uint divisor = note.duration > 0 ? note.duration : -note.duration;
+        uint shift = 0;
+        while (shift < 7 && (1u << shift) < divisor)
+            shift++;
+        if (code == T || (1u << shift) != divisor)
+            packed.valid = false;
+        code |= shift << PACKED_NOTE_LENGTH_SHIFT;
+        if (note.duration < 0)
+            code |= PACKED_NOTE_DOTTED;
+        packed.notes[packed.length++] = code;
+        packed.duration_ms += noteDuration(note, packed.whole_note_duration);
+    }
+    return packed;
+}
+
+// True when every packed note decodes to the same step as compileNote makes of the original
+template <uint32_t SysClock = BUZZER_SYS_CLOCK_HZ, size_t N>
+constexpr bool packedMatches(const PackedNotes<N> &packed, const Note (&notes)[N])
+{
+    if (!packed.valid)
+        return false;
+    for (uint i = 0; i < packed.length; i++)
+    {
+        ToneStep decoded = decodeNote(packed.notes[i], packed.whole_note_duration, packed.tones);
+        ToneStep original = compileNote(notes[i], packed.whole_note_duration, SysClock);
+        if (decoded.div != original.div || decoded.top != original.top ||
+            decoded.on_us != original.on_us || decoded.off_us != original.off_us)
+            return false;
+    }
+    return true;
+}
+
 class Buzzer
 {
 private:
     uint pin;
     uint slice_num;
+    // Either a melody converted note by note, a compiled schedule or a packed melody is played
     const Note *current_note;
+    const ToneStep *current_step;
+    const ToneStep *steps_end;
+    const uint16_t *current_packed;
+    const uint16_t *packed_end;
+    const PwmTone *tones;
+    ToneStep step;
+    bool tone_on;
     alarm_id_t current_alarm;
-    uint delay_off;
     uint whole_note_duration;
+    uint32_t sys_clock;
     uint tempo;
     volatile bool is_done;
 
+    Envelope envelope;
+    // duty of the set volume in 0.16 fixed point, see volumeDuty
+    uint32_t duty;
+    // Shape of the note playing: level at full volume, fade times shortened to fit the note, time left
+    uint16_t tone_level;
+    uint32_t attack_us;
+    uint32_t release_us;
+    uint32_t tone_left_us;
+    // Current level and its change every BUZZER_ENVELOPE_STEP_US while fading, in 16.16 fixed point
+    uint32_t level;
+    uint32_t attack_step;
+    uint32_t release_step;
+
+    // Streaming plays a whole melody from a PIO state machine fed by DMA, no interrupt per note
+    bool streaming;
+    bool stream_playing;
+    volatile bool stream_sent;
+    PIO pio;
+    uint sm;
+    uint program_offset;
+    int dma_channel;
+    // four words for every note, see buzzer.pio
+    uint32_t *stream_words;
+
     // Static callback function for the alarm
     // Having this is necessary since add_alarm_in_us() expects a specific function signature
     // and a non-static method does not fit it
@@ -37,15 +327,35 @@ private:
     // Non-static member function to handle the callback logic
     int64_t timer_note_callback(alarm_id_t id);
 
-    uint playTone();
+    // Loads the next step, false when the melody is over
+    bool nextStep();
+    // Sets the duty for the point of the note reached, returns the time until it changes again
+    uint32_t shapeTone();
+    void start();
+    // Converts the whole melody for the state machine and starts DMA, false when it is too long
+    bool startStream();
+    void stopStream();
 
-    void pwm_calc_div_top(pwm_config &cfg, int frequency, int sysClock);
+    static void dmaIrqHandler(uint channel, void *user_data);
 
 public:
-    Buzzer(uint gpio);
+    // pio is only used once streaming is enabled
+    Buzzer(uint gpio, PIO pio = pio1);
     ~Buzzer();
+    // With streaming enabled melodies are played by a PIO state machine fed through DMA, note timing does not
+    // depend on interrupts and no alarm is used. Claims a state machine of pio and a DMA channel.
+    void setStreaming(bool enabled);
+    // Applies from the next note on. Notes that fade in or out are played note by note even with streaming
+    // enabled, the state machine only plays them at a fixed volume.
+    void setEnvelope(const Envelope &envelope);
+    void setVolume(uint8_t volume);
+    const Envelope &getEnvelope() const;
     void playMelody(const Melody &melody);
     void playMelody(const Melody &melody, uint custom_tempo);
+    // Plays a melody made by compileMelody, no conversion happens while playing
+    void playMelody(const MelodySchedule &schedule);
+    // Plays a melody made by packMelody, notes are decoded one at a time while playing
+    void playMelody(const PackedMelody &melody);
     void stopMelody();
     bool isDone() const;
 };
\ No newline at end of file
@@ -1,3 +1,4 @@
+#pragma once
 #include "buzzer.h"
 
 enum NoteFreq : uint16_t
@@ -1038,3 +1039,121 @@ constexpr Note PinkPantherNotes[] = {
     {NoteFreq::E4, 16},
     {NoteFreq::E4, 2}};
 constexpr Melody PinkPantherMelody = {PinkPantherNotes, 120};
+
+// Every NoteFreq, packed notes refer to them by index
+constexpr uint16_t NoteFrequencies[] = {
+    NoteFreq::REST,
+    NoteFreq::B0, NoteFreq::C1, NoteFreq::CS1, NoteFreq::D1, NoteFreq::DS1, NoteFreq::E1, NoteFreq::F1, NoteFreq::FS1, NoteFreq::G1, NoteFreq::GS1, NoteFreq::A1, NoteFreq::AS1,
+    NoteFreq::B1, NoteFreq::C2, NoteFreq::CS2, NoteFreq::D2, NoteFreq::DS2, NoteFreq::E2, NoteFreq::F2, NoteFreq::FS2, NoteFreq::G2, NoteFreq::GS2, NoteFreq::A2, NoteFreq::AS2,
+    NoteFreq::B2, NoteFreq::C3, NoteFreq::CS3, NoteFreq::D3, NoteFreq::DS3, NoteFreq::E3, NoteFreq::F3, NoteFreq::FS3, NoteFreq::G3, NoteFreq::GS3, NoteFreq::A3, NoteFreq::AS3,
+    NoteFreq::B3, NoteFreq::C4, NoteFreq::CS4, NoteFreq::D4, NoteFreq::DS4, NoteFreq::E4, NoteFreq::F4, NoteFreq::FS4, NoteFreq::G4, NoteFreq::GS4, NoteFreq::A4, NoteFreq::AS4,
+    NoteFreq::B4, NoteFreq::C5, NoteFreq::CS5, NoteFreq::D5, NoteFreq::DS5, NoteFreq::E5, NoteFreq::F5, NoteFreq::FS5, NoteFreq::G5, NoteFreq::GS5, NoteFreq::A5, NoteFreq::AS5,
+    NoteFreq::B5, NoteFreq::C6, NoteFreq::CS6, NoteFreq::D6, NoteFreq::DS6, NoteFreq::E6, NoteFreq::F6, NoteFreq::FS6, NoteFreq::G6, NoteFreq::GS6, NoteFreq::A6, NoteFreq::AS6,
+    NoteFreq::B6, NoteFreq::C7, NoteFreq::CS7, NoteFreq::D7, NoteFreq::DS7, NoteFreq::E7, NoteFreq::F7, NoteFreq::FS7, NoteFreq::G7, NoteFreq::GS7, NoteFreq::A7, NoteFreq::AS7,
+    NoteFreq::B7, NoteFreq::C8, NoteFreq::CS8, NoteFreq::D8, NoteFreq::DS8};
+
+// PWM register values of every NoteFreq for BUZZER_SYS_CLOCK_HZ
+constexpr auto NoteTones = compileTones(NoteFrequencies);
+
+template <size_t N>
+constexpr PackedNotes<N> packNotes(const Note (&notes)[N], const Melody &melody)
+{
+    return packMelody(notes, melody.tempo, NoteFrequencies, NoteTones);
+}
+
+// Melodies packed to 2 bytes a note at build time
+constexpr auto NoPacked = packNotes(NoNotes, NoMelody);
+constexpr auto BeepPacked = packNotes(Beep, BeepMelody);
+constexpr auto BreezePacked = packNotes(Breeze, BreezeMelody);
+constexpr auto RumblePacked = packNotes(Rumble, RumbleMelody);
+constexpr auto BzzzPacked = packNotes(Bzzz, BzzzMelody);
+constexpr auto DoomPacked = packNotes(DoomNotes, DoomMelody);
+constexpr auto RickRollPacked = packNotes(RickRollNotes, RickRollMelody);
+constexpr auto NokiaPacked = packNotes(NokiaRingtone, NokiaMelody);
+constexpr auto KrabPacked = packNotes(KrabNotes, KrabMelody);
+constexpr auto PinkPantherPacked = packNotes(PinkPantherNotes, PinkPantherMelody);
+
+constexpr bool tonesMatch()
+{
+    for (uint i = 0; i < sizeof(NoteFrequencies) / sizeof(NoteFrequencies[0]); i++)
+    {
+        uint32_t expected = NoteFrequencies[i];
+        uint32_t actual = toneFrequency(NoteTones.tones[i].div, NoteTones.tones[i].top, BUZZER_SYS_CLOCK_HZ);
+        uint32_t error = actual > expected ? actual - expected : expected - actual;
+        // 0.1%, compiled frequency is rounded down so allow that 1 Hz on top
+        if (error * 1000 > expected + 1000)
+            return false;
+    }
+    return true;
+}
+
+static_assert(tonesMatch(), "compiled note frequency off");
+static_assert(packedMatches(NoPacked, NoNotes) && packedMatches(BeepPacked, Beep) &&
+                  packedMatches(BreezePacked, Breeze) && packedMatches(RumblePacked, Rumble) &&
+                  packedMatches(BzzzPacked, Bzzz) && packedMatches(DoomPacked, DoomNotes) &&
+                  packedMatches(RickRollPacked, RickRollNotes) && packedMatches(NokiaPacked, NokiaRingtone) &&
+                  packedMatches(KrabPacked, KrabNotes) && packedMatches(PinkPantherPacked, PinkPantherNotes),
+              "packed melody plays differently");
+
+// A melody that can be picked for the alarm, by its id through the API.
+// Only the packed notes are referenced, so the note arrays stay out of flash.
+struct MelodyEntry
+{
+    char id;
+    const char *name;
+    PackedMelody packed;
+    uint32_t duration_ms;
+    Envelope envelope;
+};
+
+template <size_t N>
+constexpr MelodyEntry melodyEntry(char id, const char *name, const PackedNotes<N> &packed,
+                                  const Envelope &envelope = FullEnvelope)
+{
+    return {id, name, packed, packed.duration_ms, envelope};
+}
+
+// Played for an id that is not in Melodies
+constexpr MelodyEntry NoMelodyEntry = melodyEntry('\0', "None", NoPacked);
+
+constexpr MelodyEntry Melodies[] = {
+    melodyEntry('B', "Beep", BeepPacked),
+    melodyEntry('E', "Breeze", BreezePacked),
+    melodyEntry('M', "Brrr", RumblePacked),
+    melodyEntry('Z', "Bzzz", BzzzPacked),
+    melodyEntry('D', "DOOM", DoomPacked),
+    melodyEntry('R', "Rick Roll", RickRollPacked),
+    melodyEntry('N', "Nokia ringtone", NokiaPacked),
+    melodyEntry('K', "Krusty Krab", KrabPacked),
+    melodyEntry('P', "Pink Panther", PinkPantherPacked),
+};
+
+constexpr size_t MelodyCount = sizeof(Melodies) / sizeof(Melodies[0]);
+
+constexpr const MelodyEntry &findMelody(char id)
+{
+    for (const MelodyEntry &entry : Melodies)
+        if (entry.id == id)
+            return entry;
+    return NoMelodyEntry;
+}
+
+constexpr bool melodyIdsUnique()
+{
+    for (size_t i = 0; i < MelodyCount; i++)
+    {
+        if (Melodies[i].id == 'U' || Melodies[i].id == '\0')
+            return false;
+        for (size_t j = i + 1; j < MelodyCount; j++)
+            if (Melodies[i].id == Melodies[j].id)
+                return false;
+    }
+    return true;
+}
+
+// 'U' is the uploaded melody, see MelodySlot
+static_assert(melodyIdsUnique(), "melody ids have to be unique, U and 0 are taken");
+static_assert(findMelody('R').duration_ms == melodyDuration(RickRollMelody, sizeof(RickRollNotes) / sizeof(Note)) &&
+                  findMelody('P').duration_ms == melodyDuration(PinkPantherMelody, sizeof(PinkPantherNotes) / sizeof(Note)),
+              "packed melody duration");
+static_assert(&findMelody('?') == &NoMelodyEntry, "unknown melody id");
@@ -7,11 +7,29 @@
 
 #include <string.h>
 #include <stdio.h>
+#include <stdlib.h>
+#include <ctype.h>
 #include <lwip/err.h>
 #include <lwip/pbuf.h>
 #include <lwip/tcp.h>
 #include <lwip/netif.h>
 #include <lwip/ip4.h>
+#include "rtttl.h"
+
+// Longest JSON list /api/melodies makes, with every duration taking 10 digits and the uploaded melody present.
+// An entry is {"id":"?","name":"","duration_ms":},
+constexpr size_t melodyListSize()
+{
+    constexpr size_t entry = 36 + 10;
+    size_t size = sizeof("{\"result\":\"success\",\"melodies\":[") + sizeof("]}") + entry + RTTTL_NAME_SIZE - 1;
+    for (const MelodyEntry &melody : Melodies)
+    {
+        size += entry;
+        for (const char *c = melody.name; *c; c++)
+            size++;
+    }
+    return size;
+}
 
 enum class ServerState
 {
@@ -28,9 +46,30 @@ class HTTPServer
 private:
     int current_position = 0;
     char current_melody = '\0';
+    // volume of the alarm in percent, -1 plays the melody at its own volume
+    int current_volume = -1;
+    // fade in and out of every note in ms, -1 keeps the fades of the melody
+    int current_attack = -1;
+    int current_release = -1;
+    bool quiet = false;
     char current_username[11] = {};
     ServerState state = ServerState::None;
 
+    // Melody uploaded through /api/melody, played with melody=U
+    MelodySlot uploaded_melody;
+    RtttlParser melody_parser;
+    // Connection the upload body is still coming in on, body bytes left
+    struct tcp_pcb *upload_pcb = nullptr;
+    size_t upload_remaining = 0;
+    // Polls of upload_pcb without any body bytes arriving
+    uint upload_idle_polls = 0;
+    // An upload is polled every UPLOAD_POLL_INTERVAL * 500 ms and dropped after UPLOAD_TIMEOUT_POLLS idle polls
+    static constexpr u8_t UPLOAD_POLL_INTERVAL = 2;
+    static constexpr uint UPLOAD_TIMEOUT_POLLS = 10;
+
+    // Body of /api/melodies
+    char melody_list[melodyListSize()];
+
     const char *set_error_state(const char *query)
     {
         state = ServerState::DeskError;
@@ -53,6 +92,9 @@ private:
     {
         int position = -1;
         char melody = '\0';
+        int volume = -1;
+        int attack = -1;
+        int release = -1;
 
         if (query && strlen(query) > 0)
         {
@@ -60,6 +102,9 @@ private:
             // Use const_cast since strstr doesn't work with const char *, only char *
             char *positionStr = strstr(const_cast<char *>(query), "position=");
             char *melodyStr = strstr(const_cast<char *>(query), "melody=");
+            char *volumeStr = strstr(const_cast<char *>(query), "volume=");
+            char *attackStr = strstr(const_cast<char *>(query), "attack=");
+            char *releaseStr = strstr(const_cast<char *>(query), "release=");
 
             if (positionStr)
             {
@@ -72,12 +117,30 @@ private:
                 melodyStr += 7; // Skip "melody="
                 melody = *melodyStr;
             }
+
+            if (volumeStr)
+            {
+                volumeStr += 7; // Skip "volume="
+                volume = atoi(volumeStr);
+                if (volume < 0 || volume > 100)
+                    return "{\"result\":\"error\",\"error\":\"volume has to be 0 - 100\"}";
+            }
+
+            if (attackStr)
+                attack = atoi(attackStr + 7); // Skip "attack="
+            if (releaseStr)
+                release = atoi(releaseStr + 8); // Skip "release="
+            if ((attackStr && (attack < 0 || attack > 1000)) || (releaseStr && (release < 0 || release > 1000)))
+                return "{\"result\":\"error\",\"error\":\"attack and release have to be 0 - 1000\"}";
         }
 
         if (position > 0 && melody != '\0')
         {
             current_position = position;
             current_melody = melody;
+            current_volume = volume;
+            current_attack = attack;
+            current_release = release;
             state = ServerState::Alarm;
             return "{\"result\":\"success\"}";
         }
@@ -85,6 +148,51 @@ private:
             return "{\"result\":\"error\",\"error\":\"invalid or missing parameters (position, melody) for alarm\"}";
     }
 
+    const char *set_quiet_mode(const char *query)
+    {
+        char *enabledStr = strstr(const_cast<char *>(query), "enabled=");
+
+        if (enabledStr)
+        {
+            enabledStr += 8; // Skip "enabled="
+            quiet = atoi(enabledStr) != 0;
+            return "{\"result\":\"success\"}";
+        }
+        else
+            return "{\"result\":\"error\",\"error\":\"enabled not provided\"}";
+    }
+
+    const char *list_melodies(const char *query)
+    {
+        size_t length = snprintf(melody_list, sizeof(melody_list), "{\"result\":\"success\",\"melodies\":[");
+        for (const MelodyEntry &entry : Melodies)
+            append_melody(length, entry.id, entry.name, entry.duration_ms);
+
+        if (uploaded_melody.length > 0)
+        {
+            // uploaded name is whatever the RTTTL said, keep only characters that need no escaping
+            char name[RTTTL_NAME_SIZE] = {};
+            size_t nameLength = 0;
+            for (const char *c = uploaded_melody.name; *c; c++)
+                if (*c >= ' ' && *c != '"' && *c != '\\')
+                    name[nameLength++] = *c;
+            append_melody(length, 'U', name, melodyDuration(uploaded_melody.melody()));
+        }
+
+        // replaces the comma after the last entry, melodyListSize leaves room for it
+        snprintf(melody_list + length - 1, sizeof(melody_list) - length + 1, "]}");
+        return melody_list;
+    }
+
+    // Adds an entry to melody_list, length stays within the buffer even if the entry does not fit
+    void append_melody(size_t &length, char id, const char *name, uint32_t duration_ms)
+    {
+        int written = snprintf(melody_list + length, sizeof(melody_list) - length, "{\"id\":\"%c\",\"name\":\"%s\",\"duration_ms\":%lu},",
+                               id, name, (unsigned long)duration_ms);
+        if (written > 0)
+            length = (length + written < sizeof(melody_list)) ? length + written : sizeof(melody_list) - 1;
+    }
+
     const char *set_login_state(const char *query)
     {
         char *usernameStr = strstr(const_cast<char *>(query), "username=");
@@ -141,6 +249,8 @@ private:
             {"/api/alarm", &HTTPServer::set_alarm_state},
             {"/api/login", &HTTPServer::set_login_state},
             {"/api/logout", &HTTPServer::set_logout_state},
+            {"/api/melodies", &HTTPServer::list_melodies},
+            {"/api/quiet", &HTTPServer::set_quiet_mode},
         };
 
         for (const auto &route : routes)
@@ -161,30 +271,191 @@ private:
         char path[PATH_BUFFER_SIZE] = {}, query[QUERY_BUFFER_SIZE] = {};
         parse_http_request(request, path, PATH_BUFFER_SIZE, query, QUERY_BUFFER_SIZE);
 
-        const char *responseBody = match_route_and_handle(path, query);
-        char response[256];
-        int responseLength = snprintf(response,
-                                      sizeof(response),
-                                      "HTTP/1.1 200 OK\r\nContent-Type: application/json\r\nContent-Length: %zu\r\n\r\n%s",
-                                      strlen(responseBody),
-                                      responseBody);
+        send_response(tpcb, match_route_and_handle(path, query));
+    }
 
-        tcp_write(tpcb, response, responseLength, TCP_WRITE_FLAG_COPY);
+    void send_response(struct tcp_pcb *tpcb, const char *responseBody)
+    {
+        // header and body go out as separate writes, so the body can be longer than the header buffer
+        char header[128];
+        size_t bodyLength = strlen(responseBody);
+        int headerLength = snprintf(header,
+                                    sizeof(header),
+                                    "HTTP/1.1 200 OK\r\nContent-Type: application/json\r\nContent-Length: %zu\r\n\r\n",
+                                    bodyLength);
+
+        tcp_write(tpcb, header, headerLength, TCP_WRITE_FLAG_COPY | TCP_WRITE_FLAG_MORE);
+        tcp_write(tpcb, responseBody, bodyLength, TCP_WRITE_FLAG_COPY);
         tcp_output(tpcb);
     }
 
+    // Offset of the value of a header field before headerEnd, 0xFFFF when there is none.
+    // Field names are case-insensitive, name has to be given in lower case.
+    static u16_t find_header(struct pbuf *p, const char *name, u16_t headerEnd)
+    {
+        size_t nameLength = strlen(name);
+        for (u16_t line = pbuf_memfind(p, "\r\n", 2, 0); line != 0xFFFF && line < headerEnd;
+             line = pbuf_memfind(p, "\r\n", 2, line + 2))
+        {
+            u16_t start = line + 2;
+            size_t i = 0;
+            while (i < nameLength && tolower(pbuf_get_at(p, start + i)) == name[i])
+                i++;
+            if (i == nameLength && pbuf_get_at(p, start + i) == ':')
+                return start + i + 1;
+        }
+        return 0xFFFF;
+    }
+
+    // Starts parsing the body of a POST /api/melody request, the rest arrives with later pbufs.
+    // Header has to be in the first pbuf, which it is for any sane client.
+    // Returns ERR_ABRT when the connection had to be aborted.
+    err_t start_upload(struct tcp_pcb *tpcb, struct pbuf *p)
+    {
+        // the alarm path reads the slot while it plays, so it is only replaced between alarms
+        if (state == ServerState::Alarm && current_melody == 'U')
+        {
+            send_response(tpcb, "{\"result\":\"error\",\"error\":\"uploaded melody is playing\"}");
+            return ERR_OK;
+        }
+
+        u16_t bodyStart = pbuf_memfind(p, "\r\n\r\n", 4, 0);
+        u16_t lengthStart = bodyStart == 0xFFFF ? 0xFFFF : find_header(p, "content-length", bodyStart);
+        if (lengthStart == 0xFFFF)
+        {
+            send_response(tpcb, "{\"result\":\"error\",\"error\":\"melody upload needs a Content-Length\"}");
+            return ERR_OK;
+        }
+
+        char length[12] = {};
+        pbuf_copy_partial(p, length, sizeof(length) - 1, lengthStart);
+        size_t contentLength = strtoul(length, nullptr, 10);
+
+        // no valid melody is that long, the body is not read and the rest of it would only be taken for requests
+        if (contentLength > RTTTL_MAX_TEXT_SIZE)
+        {
+            send_response(tpcb, "{\"result\":\"error\",\"error\":\"melody upload too large\"}");
+            return close_connection(tpcb);
+        }
+
+        // a connection that is reset is freed by lwIP without a call to http_recv, http_err forgets it then
+        if (upload_pcb && upload_pcb != tpcb)
+            forget_upload(upload_pcb);
+        upload_pcb = tpcb;
+        upload_remaining = contentLength;
+        upload_idle_polls = 0;
+        tcp_err(tpcb, http_err);
+        tcp_poll(tpcb, http_poll, UPLOAD_POLL_INTERVAL);
+        melody_parser.begin(&uploaded_melody);
+        receive_upload(tpcb, p, bodyStart + 4);
+        return ERR_OK;
+    }
+
+    // Feeds body bytes from offset on straight from the pbuf chain to the parser
+    void receive_upload(struct tcp_pcb *tpcb, struct pbuf *p, u16_t offset)
+    {
+        upload_idle_polls = 0;
+        for (struct pbuf *q = p; q && upload_remaining > 0; q = q->next)
+        {
+            if (offset >= q->len)
+            {
+                offset -= q->len;
+                continue;
+            }
+            size_t length = q->len - offset;
+            if (length > upload_remaining)
+                length = upload_remaining;
+            melody_parser.feed(static_cast<const char *>(q->payload) + offset, length);
+            upload_remaining -= length;
+            offset = 0;
+        }
+
+        if (upload_remaining > 0)
+            return;
+
+        forget_upload(tpcb);
+        if (melody_parser.finish())
+        {
+            printf("Melody uploaded: %s, %u notes\n", uploaded_melody.name, uploaded_melody.length);
+            send_response(tpcb, "{\"result\":\"success\"}");
+        }
+        else
+            send_response(tpcb, "{\"result\":\"error\",\"error\":\"invalid RTTTL melody\"}");
+    }
+
+    // Stops receiving an upload on tpcb, its callbacks are not needed anymore
+    void forget_upload(struct tcp_pcb *tpcb)
+    {
+        upload_pcb = nullptr;
+        upload_remaining = 0;
+        tcp_err(tpcb, nullptr);
+        tcp_poll(tpcb, nullptr, 0);
+    }
+
+    // Closes tpcb after what was written to it, ERR_ABRT when it had to be aborted instead
+    static err_t close_connection(struct tcp_pcb *tpcb)
+    {
+        if (tcp_close(tpcb) == ERR_OK)
+            return ERR_OK;
+        tcp_abort(tpcb);
+        return ERR_ABRT;
+    }
+
     static err_t http_recv(void *arg, struct tcp_pcb *tpcb, struct pbuf *p, err_t err)
     {
+        HTTPServer *server = static_cast<HTTPServer *>(arg);
         if (!p)
+        {
+            if (server->upload_pcb == tpcb)
+                server->forget_upload(tpcb);
             return tcp_close(tpcb), ERR_OK;
+        }
+        tcp_recved(tpcb, p->tot_len);
+
+        if (server->upload_pcb == tpcb)
+        {
+            server->receive_upload(tpcb, p, 0);
+            pbuf_free(p);
+            return ERR_OK;
+        }
 
         constexpr size_t REQUEST_BUFFER_SIZE = 128;
         char request[REQUEST_BUFFER_SIZE] = {};
         pbuf_copy_partial(p, request, sizeof(request) - 1, 0);
+
+        // a new upload takes over the melody slot from one that never finished.
+        // The whole path has to match, "POST /api/melodyX" is not an upload
+        err_t result = ERR_OK;
+        if (strncmp(request, "POST /api/melody", 16) == 0 && (request[16] == ' ' || request[16] == '?'))
+            result = server->start_upload(tpcb, p);
+        else
+            server->handle_request(tpcb, request);
         pbuf_free(p);
+        return result;
+    }
 
-        static_cast<HTTPServer *>(arg)->handle_request(tpcb, request);
-        return ERR_OK;
+    // Only registered on the connection of an unfinished upload. A client that stops sending the body would keep
+    // the melody slot from being uploaded again, so the upload is dropped with an error after a while.
+    static err_t http_poll(void *arg, struct tcp_pcb *tpcb)
+    {
+        HTTPServer *server = static_cast<HTTPServer *>(arg);
+        if (server->upload_pcb != tpcb || ++server->upload_idle_polls < UPLOAD_TIMEOUT_POLLS)
+            return ERR_OK;
+
+        printf("Melody upload timed out, %zu bytes missing\n", server->upload_remaining);
+        server->forget_upload(tpcb);
+        // leaves an empty slot rather than the notes that arrived
+        server->melody_parser.begin(&server->uploaded_melody);
+        server->send_response(tpcb, "{\"result\":\"error\",\"error\":\"melody upload timed out\"}");
+        return close_connection(tpcb);
+    }
+
+    // Only registered on the connection of an unfinished upload, the pcb is already freed when this is called
+    static void http_err(void *arg, err_t err)
+    {
+        HTTPServer *server = static_cast<HTTPServer *>(arg);
+        server->upload_pcb = nullptr;
+        server->upload_remaining = 0;
     }
 
     static err_t http_accept(void *arg, struct tcp_pcb *newpcb, err_t err)
@@ -227,6 +498,34 @@ public:
         return current_melody;
     }
 
+    // Volume asked for with the alarm in percent, -1 when none was given
+    int get_volume()
+    {
+        return current_volume;
+    }
+
+    // Fade in and out of notes asked for with the alarm in ms, -1 when none was given
+    int get_attack()
+    {
+        return current_attack;
+    }
+
+    int get_release()
+    {
+        return current_release;
+    }
+
+    bool is_quiet()
+    {
+        return quiet;
+    }
+
+    // Empty until a melody was uploaded
+    const MelodySlot &get_uploaded_melody() const
+    {
+        return uploaded_melody;
+    }
+
     char *get_username()
     {
         return current_username;
@@ -0,0 +1,53 @@
+#ifndef SSD1306_PAGEIMAGE_H
+#define SSD1306_PAGEIMAGE_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+namespace pico_ssd1306 {
+
+    /// \struct pico_ssd1306::PageImage
+    /// \brief 1bpp image laid out the same way as ssd1306 display RAM
+    ///
+    /// Image is (Height + 7) / 8 pages, one after another, and every page is Width bytes, one per column with
+    /// bit 0 as the topmost pixel. Rows below Height in the last page are 0.
+    /// Use makePageImage to build one from a row-major bitmap at compile time, draw it with SSD1306::addPageImage.
+    template<uint8_t Width, uint8_t Height>
+    struct PageImage {
+        static constexpr uint8_t width = Width;
+        static constexpr uint8_t height = Height;
+        static constexpr uint8_t pages = (Height + 7) / 8;
+
+        /// image data, page after page
+        uint8_t data[pages * Width];
+    };
+
+    /// \brief Converts a row-major bitmap, as taken by SSD1306::addBitmapImage, into a PageImage
+    ///
+    /// Runs at compile time, so only the converted image ends up in flash.
+    /// Every row of source is (Width + 7) / 8 bytes, most significant bit being the leftmost pixel,
+    /// the same layout SSD1306::addBitmapImage takes. Padding bits at the end of a row are ignored.
+    ///
+    /// ex. constexpr auto bellIcon = makePageImage<16, 16>(bell_bitmap);
+    /// \tparam Width, Height - image size in pixels
+    /// \param rows - source bitmap
+    template<uint8_t Width, uint8_t Height, size_t N>
+    constexpr PageImage<Width, Height> makePageImage(const unsigned char (&rows)[N]) {
+        constexpr size_t stride = (Width + 7) / 8;
+        static_assert(N == stride * Height, "bitmap size does not match image size");
+
+        PageImage<Width, Height> result{};
+
+        for (uint8_t y = 0; y < Height; y++) {
+            for (uint8_t x = 0; x < Width; x++) {
+                if ((rows[y * stride + x / 8] >> (7 - (x & 7))) & 1) {
+                    result.data[(y / 8) * Width + x] |= 1 << (y & 7);
+                }
+            }
+        }
+
+        return result;
+    }
+}
+
+#endif //SSD1306_PAGEIMAGE_H
@@ -0,0 +1,36 @@
+#include "Layer.h"
+
+namespace pico_ssd1306 {
+    Layer::Layer() {
+        this->pixels = nullptr;
+        this->valid = false;
+    }
+
+    Layer::~Layer() {
+        delete[] this->pixels;
+    }
+
+    bool Layer::isValid() const {
+        return this->valid;
+    }
+
+    void Layer::invalidate() {
+        this->valid = false;
+    }
+
+    void Layer::capture(SSD1306 *ssd1306) {
+        if (!this->pixels) this->pixels = new unsigned char[FRAMEBUFFER_SIZE];
+        ssd1306->copyBuffer(this->pixels);
+        this->valid = true;
+    }
+
+    void Layer::restore(SSD1306 *ssd1306) const {
+        if (!this->valid) return;
+        ssd1306->setBuffer(this->pixels);
+    }
+
+    void Layer::restore(SSD1306 *ssd1306, const Rect &area) const {
+        if (!this->valid) return;
+        ssd1306->restoreArea(this->pixels, area.x0, area.y0, area.x1, area.y1);
+    }
+}
@@ -0,0 +1,49 @@
+#ifndef SSD1306_LAYER_H
+#define SSD1306_LAYER_H
+
+#include "Widget.h"
+
+namespace pico_ssd1306 {
+
+    /// \class Layer Layer.h "pico-ssd1306/compositor/Layer.h"
+    /// \brief Pre-rendered full screen image, e.g. static text of a screen
+    ///
+    /// Static parts of a screen are rasterized once and captured into a layer. Following frames restore
+    /// the layer, whole with a single copy or just the bounds of a changed widget, instead of drawing them again.
+    class Layer {
+        unsigned char *pixels;
+        bool valid;
+    public:
+        /// Constructs empty layer, memory for its pixels is only allocated by the first capture
+        Layer();
+
+        /// Destroys layer and frees its memory
+        ~Layer();
+
+        /// Layer owns its pixels, copies would free them twice
+        Layer(const Layer &) = delete;
+        Layer &operator=(const Layer &) = delete;
+
+        /// \brief Checks whether layer holds a captured image
+        /// \return false until capture() is called and after invalidate()
+        bool isValid() const;
+
+        /// Marks layer as outdated, so that it gets rendered and captured again
+        void invalidate();
+
+        /// \brief Stores current frame buffer content of display in the layer
+        /// \param ssd1306 - pointer to a SSD1306 object aka initialised display
+        void capture(SSD1306 *ssd1306);
+
+        /// \brief Replaces frame buffer content with the layer, does nothing if layer is not valid
+        /// \param ssd1306 - pointer to a SSD1306 object aka initialised display
+        void restore(SSD1306 *ssd1306) const;
+
+        /// \brief Replaces a rectangle of frame buffer with the layer, does nothing if layer is not valid
+        /// \param ssd1306 - pointer to a SSD1306 object aka initialised display
+        /// \param area - rectangle to restore, pixels outside of it are left alone
+        void restore(SSD1306 *ssd1306, const Rect &area) const;
+    };
+}
+
+#endif //SSD1306_LAYER_H
@@ -0,0 +1,107 @@
+#include "Screen.h"
+
+namespace pico_ssd1306 {
+    Screen::Screen(SSD1306 *ssd1306) {
+        this->ssd1306 = ssd1306;
+        this->widgets = nullptr;
+        this->staticWidgets = nullptr;
+        this->restoreAll = false;
+    }
+
+    void Screen::add(Widget &widget) {
+        // appended so that drawing order follows order of adding
+        Widget **link = &this->widgets;
+        while (*link) link = &(*link)->next;
+        widget.next = nullptr;
+        widget.dirty = true;
+        *link = &widget;
+    }
+
+    void Screen::addStatic(Widget &widget) {
+        Widget **link = &this->staticWidgets;
+        while (*link) link = &(*link)->next;
+        widget.next = nullptr;
+        widget.dirty = true;
+        *link = &widget;
+    }
+
+    void Screen::invalidate() {
+        for (Widget *widget = this->widgets; widget; widget = widget->next) {
+            widget->dirty = true;
+        }
+        this->restoreAll = this->staticWidgets != nullptr;
+    }
+
+    bool Screen::isDirty() const {
+        if (this->restoreAll) return true;
+        for (Widget *widget = this->staticWidgets; widget; widget = widget->next) {
+            if (widget->dirty) return true;
+        }
+        for (Widget *widget = this->widgets; widget; widget = widget->next) {
+            if (widget->dirty) return true;
+        }
+        return false;
+    }
+
+    void Screen::clearArea(const Rect &bounds) {
+        if (this->staticWidgets) {
+            this->background.restore(this->ssd1306, bounds);
+        } else {
+            this->ssd1306->fillArea(bounds.x0, bounds.y0, bounds.x1, bounds.y1, WriteMode::SUBTRACT);
+        }
+    }
+
+    uint8_t Screen::render(Rect *dirtyRects, uint8_t maxRects) {
+        // frame buffer already holds the whole background once it was rendered or restored
+        bool cleared = false;
+
+        if (this->staticWidgets) {
+            bool rebuild = !this->background.isValid();
+            for (Widget *widget = this->staticWidgets; widget; widget = widget->next) {
+                rebuild = rebuild || widget->dirty;
+            }
+
+            if (rebuild) {
+                this->ssd1306->clear();
+                for (Widget *widget = this->staticWidgets; widget; widget = widget->next) {
+                    if (widget->visible) widget->render(this->ssd1306);
+                    widget->dirty = false;
+                }
+                this->background.capture(this->ssd1306);
+                this->invalidate();
+                cleared = true;
+            } else if (this->restoreAll) {
+                this->background.restore(this->ssd1306);
+                cleared = true;
+            }
+            this->restoreAll = false;
+        }
+
+        uint8_t count = 0;
+
+        for (Widget *widget = this->widgets; widget; widget = widget->next) {
+            if (!widget->dirty) continue;
+            const Rect &bounds = widget->bounds;
+            if (!cleared && (!widget->visible || !widget->isOpaque())) this->clearArea(bounds);
+            if (dirtyRects && count < maxRects) dirtyRects[count] = bounds;
+            count++;
+        }
+        if (count == 0) return 0;
+
+        for (Widget *widget = this->widgets; widget; widget = widget->next) {
+            if (!widget->visible) continue;
+
+            // a clean widget has to be drawn again when clearing a dirty one erased part of it
+            bool draw = widget->dirty;
+            for (Widget *other = this->widgets; other && !draw; other = other->next) {
+                draw = other->dirty && other->bounds.intersects(widget->bounds);
+            }
+            if (draw) widget->render(this->ssd1306);
+        }
+
+        for (Widget *widget = this->widgets; widget; widget = widget->next) {
+            widget->dirty = false;
+        }
+        return count;
+    }
+}
@@ -0,0 +1,69 @@
+#ifndef SSD1306_SCREEN_H
+#define SSD1306_SCREEN_H
+
+#include "Widget.h"
+#include "Layer.h"
+
+namespace pico_ssd1306 {
+
+    /// \class Screen Screen.h "pico-ssd1306/compositor/Screen.h"
+    /// \brief Set of widgets drawn together, only the ones that changed are rasterized again
+    ///
+    /// Widgets are not owned and have to outlive the screen. Screen only ever draws inside of widget bounds,
+    /// anything else in the frame buffer is left alone, unless it has static widgets, see addStatic.
+    class Screen {
+        SSD1306 *ssd1306;
+
+        /// first widget, widgets are chained through Widget::next
+        Widget *widgets;
+
+        /// first static widget, chained the same way
+        Widget *staticWidgets;
+
+        /// static widgets rasterized on an empty frame
+        Layer background;
+
+        /// whole frame has to be restored from background, set by invalidate
+        bool restoreAll;
+
+        /// Clears bounds of a widget to be drawn again, to background if there is one
+        void clearArea(const Rect &bounds);
+    public:
+        /// \brief Screen constructor
+        /// \param ssd1306 - pointer to a SSD1306 object aka initialised display
+        Screen(SSD1306 *ssd1306);
+
+        /// \brief Adds widget to the screen, widgets added later are drawn on top of earlier ones
+        /// \param widget - widget to add, it can only belong to one screen
+        void add(Widget &widget);
+
+        /// \brief Adds widget to the static background of the screen, e.g. a fixed title or footer
+        ///
+        /// Static widgets are rasterized once on an empty frame and captured into a Layer. Afterwards the
+        /// background is restored from the layer, whole with a single copy after invalidate or just the bounds of
+        /// a changed widget, and static widgets are not drawn again. Changing a static widget renders the layer
+        /// again. A screen with static widgets owns the whole frame buffer.
+        /// \param widget - widget to add, it can only belong to one screen, it is drawn below all added ones
+        void addStatic(Widget &widget);
+
+        /// Marks every widget dirty, needed after frame buffer was changed behind the screen's back, ex. cleared
+        ///
+        /// Static background is not rendered again, it is restored from its layer.
+        void invalidate();
+
+        /// \brief Checks whether any widget changed since last render call
+        bool isDirty() const;
+
+        /// \brief Rasterizes widgets that changed since last call
+        ///
+        /// Bounds of every dirty widget are cleared and drawn again, together with clean widgets overlapping them.
+        /// Clearing marks exactly those bounds as changed in the frame buffer, so a following sendBuffer or
+        /// sendBufferAsync sends only them. Opaque widgets are not cleared, they overwrite their bounds themselves.
+        /// \param dirtyRects - optional array receiving bounds of the dirty widgets
+        /// \param maxRects - size of dirtyRects
+        /// \return number of dirty widgets, may be larger than maxRects
+        uint8_t render(Rect *dirtyRects = nullptr, uint8_t maxRects = 0);
+    };
+}
+
+#endif //SSD1306_SCREEN_H
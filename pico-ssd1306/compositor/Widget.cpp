@@ -0,0 +1,32 @@
+#include "Widget.h"
+
+namespace pico_ssd1306 {
+    Widget::Widget(int16_t x, int16_t y, int16_t width, int16_t height) {
+        this->next = nullptr;
+        this->bounds = {x, y, (int16_t) (x + width - 1), (int16_t) (y + height - 1)};
+        this->dirty = true;
+        this->visible = true;
+    }
+
+    void Widget::markDirty() {
+        this->dirty = true;
+    }
+
+    const Rect &Widget::getBounds() const {
+        return this->bounds;
+    }
+
+    bool Widget::isDirty() const {
+        return this->dirty;
+    }
+
+    bool Widget::isVisible() const {
+        return this->visible;
+    }
+
+    void Widget::setVisible(bool visible) {
+        if (visible == this->visible) return;
+        this->visible = visible;
+        this->markDirty();
+    }
+}
@@ -0,0 +1,70 @@
+#ifndef SSD1306_WIDGET_H
+#define SSD1306_WIDGET_H
+
+#include "../ssd1306.h"
+
+namespace pico_ssd1306 {
+
+    /// \struct pico_ssd1306::Rect
+    /// \brief Rectangle on the display, both corners are inside of it
+    struct Rect {
+        int16_t x0, y0, x1, y1;
+
+        /// \brief Checks whether two rectangles share at least one pixel
+        bool intersects(const Rect &other) const {
+            return x0 <= other.x1 && other.x0 <= x1 && y0 <= other.y1 && other.y0 <= y1;
+        }
+    };
+
+    class Screen;
+
+    /// \class Widget Widget.h "pico-ssd1306/compositor/Widget.h"
+    /// \brief Element of a Screen that occupies a fixed rectangle and knows when it has to be drawn again
+    ///
+    /// Setters of derived widgets call markDirty only when the shown value really changes,
+    /// so a Screen::render pass only touches widgets that look different.
+    class Widget {
+        /// next widget of the same screen
+        Widget *next;
+
+        friend class Screen;
+    protected:
+        Rect bounds;
+        bool dirty;
+        bool visible;
+
+        /// Marks widget to be drawn again by next Screen::render call
+        void markDirty();
+
+    public:
+        /// \brief Widget constructor, widget starts visible and dirty
+        /// \param x, y - top left corner
+        /// \param width, height - size in pixels
+        Widget(int16_t x, int16_t y, int16_t width, int16_t height);
+
+        virtual ~Widget() = default;
+
+        /// \brief Draws widget into frame buffer
+        ///
+        /// Called by Screen::render with bounds already cleared, drawing has to stay inside of bounds.
+        /// \param ssd1306 - pointer to a SSD1306 object aka initialised display
+        virtual void render(SSD1306 *ssd1306) const = 0;
+
+        /// \brief Tells whether render writes every pixel of bounds, so that bounds do not have to be cleared first
+        virtual bool isOpaque() const { return false; }
+
+        /// \brief Returns rectangle widget draws in
+        const Rect &getBounds() const;
+
+        /// \brief Checks whether widget changed since last Screen::render call
+        bool isDirty() const;
+
+        /// \brief Checks whether widget is drawn
+        bool isVisible() const;
+
+        /// \brief Shows or hides widget, a hidden widget leaves its bounds cleared
+        void setVisible(bool visible);
+    };
+}
+
+#endif //SSD1306_WIDGET_H
@@ -0,0 +1,55 @@
+#include "Widgets.h"
+#include "../shapeRenderer/ShapeRenderer.h"
+
+namespace pico_ssd1306 {
+    ProgressBar::ProgressBar(int16_t x, int16_t y, int16_t width, int16_t height, uint16_t max)
+            : Widget(x, y, width, height) {
+        this->value = 0;
+        this->max = max;
+        this->filled = 0;
+    }
+
+    int16_t ProgressBar::filledWidth() const {
+        // same rounding as drawProgressBar
+        int16_t inside = this->bounds.x1 - this->bounds.x0 - 3;
+        if (inside <= 0 || this->max == 0) return 0;
+        return (int32_t) inside * this->value / this->max;
+    }
+
+    void ProgressBar::setValue(uint16_t value) {
+        if (value > this->max) value = this->max;
+        this->value = value;
+
+        int16_t filled = this->filledWidth();
+        if (filled == this->filled) return;
+        this->filled = filled;
+        this->markDirty();
+    }
+
+    void ProgressBar::setMax(uint16_t max) {
+        this->max = max;
+        this->setValue(this->value);
+    }
+
+    void ProgressBar::render(SSD1306 *ssd1306) const {
+        drawProgressBar(ssd1306, this->bounds.x0, this->bounds.y0, this->bounds.x1, this->bounds.y1, this->value,
+                        this->max);
+    }
+
+    Icon::Icon(int16_t x, int16_t y, uint8_t width, uint8_t height, const uint8_t *image)
+            : Widget(x, y, width, height) {
+        this->image = image;
+    }
+
+    void Icon::setImage(const uint8_t *image) {
+        if (image == this->image) return;
+        this->image = image;
+        this->markDirty();
+    }
+
+    void Icon::render(SSD1306 *ssd1306) const {
+        if (!this->image) return;
+        ssd1306->addPageImage(this->bounds.x0, this->bounds.y0, this->bounds.x1 - this->bounds.x0 + 1,
+                              this->bounds.y1 - this->bounds.y0 + 1, this->image);
+    }
+}
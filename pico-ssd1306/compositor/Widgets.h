@@ -0,0 +1,195 @@
+#ifndef SSD1306_WIDGETS_H
+#define SSD1306_WIDGETS_H
+
+#include <stdio.h>
+#include "Widget.h"
+#include "../textRenderer/TextRenderer.h"
+
+/// \brief Longest text a Label holds including terminating 0, longer text is cut
+#define LABEL_TEXT_SIZE 32
+
+namespace pico_ssd1306 {
+
+    /// Glyph width of a font array
+    inline uint8_t fontWidth(const unsigned char *font) { return font[0]; }
+
+    /// Glyph height of a font array
+    inline uint8_t fontHeight(const unsigned char *font) { return font[1]; }
+
+    /// Glyph width of a PageFont
+    template<uint8_t Width, uint8_t Height, size_t Count>
+    constexpr uint8_t fontWidth(const PageFont<Width, Height, Count> &) { return Width; }
+
+    /// Glyph height of a PageFont
+    template<uint8_t Width, uint8_t Height, size_t Count>
+    constexpr uint8_t fontHeight(const PageFont<Width, Height, Count> &) { return Height; }
+
+    /// \class Label Widgets.h "pico-ssd1306/compositor/Widgets.h"
+    /// \brief Single line of text
+    /// \tparam Font - either a font array or a PageFont
+    template<typename Font>
+    class Label : public Widget {
+        const Font &font;
+        uint8_t length;
+        char text[LABEL_TEXT_SIZE];
+    public:
+        /// \brief Label constructor
+        /// \param font - font to draw with, has to outlive the label
+        /// \param x, y - top left corner
+        /// \param length - number of characters the label has room for, up to LABEL_TEXT_SIZE - 1
+        /// \param text - initial text
+        Label(const Font &font, int16_t x, int16_t y, uint8_t length, const char *text = "")
+                : Widget(x, y, length * fontWidth(font), fontHeight(font)), font(font),
+                  length(length < LABEL_TEXT_SIZE ? length : LABEL_TEXT_SIZE - 1) {
+            this->text[0] = '\0';
+            this->setText(text);
+        }
+
+        /// \brief Changes shown text, label is only marked dirty if text differs
+        /// \param text - text to show, it is copied and cut to the length of the label
+        void setText(const char *text) {
+            if (!text) text = "";
+            if (strncmp(this->text, text, this->length) == 0) return;
+            strncpy(this->text, text, this->length);
+            this->text[this->length] = '\0';
+            this->markDirty();
+        }
+
+        /// \brief Returns shown text
+        const char *getText() const {
+            return this->text;
+        }
+
+        void render(SSD1306 *ssd1306) const override {
+            drawText(ssd1306, this->font, this->text, this->bounds.x0, this->bounds.y0);
+        }
+    };
+
+    /// \brief Tells whether Font is a PageFont
+    template<typename Font>
+    struct IsPageFont {
+        static constexpr bool value = false;
+    };
+
+    template<uint8_t Width, uint8_t Height, size_t Count>
+    struct IsPageFont<PageFont<Width, Height, Count>> {
+        static constexpr bool value = true;
+    };
+
+    template<uint8_t Width, uint8_t Height, size_t Count>
+    struct IsPageFont<const PageFont<Width, Height, Count>> {
+        static constexpr bool value = true;
+    };
+
+    /// \class BigClock Widgets.h "pico-ssd1306/compositor/Widgets.h"
+    /// \brief Time of day as HH:MM or HH:MM:SS
+    ///
+    /// With a PageFont every character is copied in as a tile of whole bytes, overwriting the previous one.
+    /// Unchanged characters compare equal and are not sent again, so a tick only sends the digits that changed.
+    /// \tparam Font - either a font array or a PageFont, has to hold digits and ':'
+    template<typename Font>
+    class BigClock : public Widget {
+        const Font &font;
+        bool showSeconds;
+        uint8_t hour, minute, second;
+    public:
+        /// \brief BigClock constructor, shows 00:00 until setTime is called
+        /// \param font - font to draw with, has to outlive the clock
+        /// \param x, y - top left corner
+        /// \param showSeconds - show HH:MM:SS instead of HH:MM, 8 characters instead of 5
+        BigClock(const Font &font, int16_t x, int16_t y, bool showSeconds = false)
+                : Widget(x, y, (showSeconds ? 8 : 5) * fontWidth(font), fontHeight(font)), font(font),
+                  showSeconds(showSeconds), hour(0), minute(0), second(0) {}
+
+        /// \brief Changes shown time, clock is only marked dirty if shown part of it differs
+        void setTime(uint8_t hour, uint8_t minute, uint8_t second = 0) {
+            if (!this->showSeconds) second = 0;
+            if (hour == this->hour && minute == this->minute && second == this->second) return;
+            this->hour = hour;
+            this->minute = minute;
+            this->second = second;
+            this->markDirty();
+        }
+
+        bool isOpaque() const override {
+            return IsPageFont<Font>::value;
+        }
+
+        void render(SSD1306 *ssd1306) const override {
+            char text[9];
+            if (this->showSeconds) {
+                snprintf(text, sizeof(text), "%02d:%02d:%02d", this->hour % 100, this->minute % 100, this->second % 100);
+            } else {
+                snprintf(text, sizeof(text), "%02d:%02d", this->hour % 100, this->minute % 100);
+            }
+
+            if constexpr (IsPageFont<Font>::value) {
+                uint8_t width = fontWidth(this->font);
+                for (uint8_t n = 0; text[n] != '\0'; n++) {
+                    copyChar(ssd1306, this->font, text[n], this->bounds.x0 + n * width, this->bounds.y0);
+                }
+            } else {
+                drawText(ssd1306, this->font, text, this->bounds.x0, this->bounds.y0);
+            }
+        }
+    };
+
+    /// \class ProgressBar Widgets.h "pico-ssd1306/compositor/Widgets.h"
+    /// \brief Horizontal bar filling up from left, see drawProgressBar
+    class ProgressBar : public Widget {
+        uint16_t value, max;
+
+        /// filled width the bar was last marked dirty for
+        int16_t filled;
+
+        /// Returns filled width for current value
+        int16_t filledWidth() const;
+    public:
+        /// \brief ProgressBar constructor, bar starts empty
+        /// \param x, y - top left corner of the outline
+        /// \param width, height - outline size, inside of the bar is 4 px smaller
+        /// \param max - value at which bar is full
+        ProgressBar(int16_t x, int16_t y, int16_t width, int16_t height, uint16_t max);
+
+        /// \brief Changes progress, bar is only marked dirty if the filled part changes by at least a pixel
+        /// \param value - progress, clamped to max
+        void setValue(uint16_t value);
+
+        /// \brief Changes value at which bar is full
+        void setMax(uint16_t max);
+
+        void render(SSD1306 *ssd1306) const override;
+    };
+
+    /// \class Icon Widgets.h "pico-ssd1306/compositor/Widgets.h"
+    /// \brief Image in display RAM layout, see SSD1306::addPageImage
+    ///
+    /// Switching between images of the same size makes simple animations.
+    class Icon : public Widget {
+        const uint8_t *image;
+    public:
+        /// \brief Icon constructor
+        /// \param x, y - top left corner
+        /// \param width, height - image size in pixels
+        /// \param image - image data, has to outlive the icon
+        Icon(int16_t x, int16_t y, uint8_t width, uint8_t height, const uint8_t *image);
+
+        /// \brief Icon constructor taking a PageImage, the image has to outlive the icon
+        template<uint8_t Width, uint8_t Height>
+        Icon(int16_t x, int16_t y, const PageImage<Width, Height> &image) : Icon(x, y, Width, Height, image.data) {}
+
+        /// \brief Changes shown image, it has to be the same size as the one the icon was made with
+        /// \param image - image data, has to outlive the icon
+        void setImage(const uint8_t *image);
+
+        /// \brief Changes shown image, see setImage
+        template<uint8_t Width, uint8_t Height>
+        void setImage(const PageImage<Width, Height> &image) {
+            this->setImage(image.data);
+        }
+
+        void render(SSD1306 *ssd1306) const override;
+    };
+}
+
+#endif //SSD1306_WIDGETS_H
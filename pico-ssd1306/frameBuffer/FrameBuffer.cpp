@@ -1,43 +1,149 @@
 #include "FrameBuffer.h"
 
 FrameBuffer::FrameBuffer() {
-    this->buffer = new unsigned char[FRAMEBUFFER_SIZE];
+    this->storage = new unsigned char[FRAMEBUFFER_PREFIX + FRAMEBUFFER_SIZE];
+    this->buffer = this->storage + FRAMEBUFFER_PREFIX;
+    this->markAllDirty();
 }
 
 FrameBuffer::~FrameBuffer() {
-    delete[] this->buffer;
+    delete[] this->storage;
 }
 
 void FrameBuffer::byteOR(int n, unsigned char byte) {
     // return if index outside 0 - buffer length - 1
     if (n > (FRAMEBUFFER_SIZE-1)) return;
     this->buffer[n] |= byte;
+    this->markDirty(n);
 }
 
 void FrameBuffer::byteAND(int n, unsigned char byte) {
     // return if index outside 0 - buffer length - 1
     if (n > (FRAMEBUFFER_SIZE-1)) return;
     this->buffer[n] &= byte;
+    this->markDirty(n);
 }
 
 void FrameBuffer::byteXOR(int n, unsigned char byte) {
     // return if index outside 0 - buffer length - 1
     if (n > (FRAMEBUFFER_SIZE-1)) return;
     this->buffer[n] ^= byte;
+    this->markDirty(n);
 }
 
+void FrameBuffer::spanOR(int n, int count, unsigned char byte) {
+    // return if span is empty or starts outside 0 - buffer length - 1
+    if (count <= 0 || n < 0 || n > (FRAMEBUFFER_SIZE-1)) return;
+    if (byte == 0xFF) {
+        memset(this->buffer + n, 0xFF, count);
+    } else {
+        for (int i = n; i < n + count; i++) this->buffer[i] |= byte;
+    }
+    this->markDirty(n, count);
+}
+
+void FrameBuffer::spanAND(int n, int count, unsigned char byte) {
+    // return if span is empty or starts outside 0 - buffer length - 1
+    if (count <= 0 || n < 0 || n > (FRAMEBUFFER_SIZE-1)) return;
+    if (byte == 0x00) {
+        memset(this->buffer + n, 0x00, count);
+    } else {
+        for (int i = n; i < n + count; i++) this->buffer[i] &= byte;
+    }
+    this->markDirty(n, count);
+}
+
+void FrameBuffer::spanXOR(int n, int count, unsigned char byte) {
+    // return if span is empty or starts outside 0 - buffer length - 1
+    if (count <= 0 || n < 0 || n > (FRAMEBUFFER_SIZE-1)) return;
+    for (int i = n; i < n + count; i++) this->buffer[i] ^= byte;
+    this->markDirty(n, count);
+}
+
+void FrameBuffer::setBytes(int n, const unsigned char *bytes, int count) {
+    // return if span is empty or starts outside 0 - buffer length - 1
+    if (count <= 0 || n < 0 || n > (FRAMEBUFFER_SIZE-1)) return;
+
+    // narrow down to the bytes that change, so that an identical copy costs nothing when flushing
+    int first = 0, last = count - 1;
+    while (first <= last && this->buffer[n + first] == bytes[first]) first++;
+    while (last >= first && this->buffer[n + last] == bytes[last]) last--;
+    if (first > last) return;
+
+    memcpy(this->buffer + n + first, bytes + first, last - first + 1);
+    this->markDirty(n + first, last - first + 1);
+}
+
+void FrameBuffer::spanCopy(int n, int count, const unsigned char *source, unsigned char mask) {
+    if (mask == 0xFF) {
+        this->setBytes(n, source + n, count);
+        return;
+    }
+
+    // return if span is empty or starts outside 0 - buffer length - 1
+    if (count <= 0 || n < 0 || n > (FRAMEBUFFER_SIZE-1)) return;
+
+    int first = -1, last = -1;
+    for (int i = n; i < n + count; i++) {
+        unsigned char byte = (this->buffer[i] & ~mask) | (source[i] & mask);
+        if (byte == this->buffer[i]) continue;
+        this->buffer[i] = byte;
+        if (first < 0) first = i;
+        last = i;
+    }
+    if (first >= 0) this->markDirty(first, last - first + 1);
+}
 
-void FrameBuffer::setBuffer(unsigned char *new_buffer) {
-    // free buffer memory to prevent memory leak
-    delete[] this->buffer;
-    this->buffer = new_buffer;
+void FrameBuffer::setBuffer(const unsigned char *new_buffer) {
+    // buffer is copied so that the prefix in front of it stays in place
+    memcpy(this->buffer, new_buffer, FRAMEBUFFER_SIZE);
+    this->markAllDirty();
 }
 
 void FrameBuffer::clear() {
     //zeroes out the buffer via memset function from string library
     memset(this->buffer, 0, FRAMEBUFFER_SIZE);
+    // display side compares against what it sent last time, so a clear followed by an identical redraw costs nothing
+    this->markAllDirty();
 }
 
 unsigned char *FrameBuffer::get() {
     return this->buffer;
 }
+
+unsigned char *FrameBuffer::getPrefixed() {
+    return this->storage;
+}
+
+void FrameBuffer::markDirty(int n) {
+    int page = n / FRAMEBUFFER_WIDTH;
+    unsigned char column = n % FRAMEBUFFER_WIDTH;
+    if (column < this->dirtyStart[page]) this->dirtyStart[page] = column;
+    if (column > this->dirtyEnd[page]) this->dirtyEnd[page] = column;
+}
+
+void FrameBuffer::markDirty(int n, int count) {
+    int page = n / FRAMEBUFFER_WIDTH;
+    unsigned char first = n % FRAMEBUFFER_WIDTH;
+    unsigned char last = first + count - 1;
+    if (first < this->dirtyStart[page]) this->dirtyStart[page] = first;
+    if (last > this->dirtyEnd[page]) this->dirtyEnd[page] = last;
+}
+
+bool FrameBuffer::getDirtyColumns(int page, int &start, int &end) const {
+    if (this->dirtyStart[page] > this->dirtyEnd[page]) return false;
+    start = this->dirtyStart[page];
+    end = this->dirtyEnd[page];
+    return true;
+}
+
+void FrameBuffer::markAllDirty() {
+    memset(this->dirtyStart, 0, FRAMEBUFFER_PAGES);
+    memset(this->dirtyEnd, FRAMEBUFFER_WIDTH - 1, FRAMEBUFFER_PAGES);
+}
+
+void FrameBuffer::clearDirty() {
+    // start past end marks a page as clean
+    memset(this->dirtyStart, 0xFF, FRAMEBUFFER_PAGES);
+    memset(this->dirtyEnd, 0, FRAMEBUFFER_PAGES);
+}
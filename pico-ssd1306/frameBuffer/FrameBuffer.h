@@ -9,9 +9,32 @@
 /// This is explained in readme.md
 #define FRAMEBUFFER_SIZE 1024
 
+/// \brief Width of one page in bytes, one byte per column
+#define FRAMEBUFFER_WIDTH 128
+
+/// \brief Number of 8 pixel tall pages in frame buffer
+#define FRAMEBUFFER_PAGES 8
+
+/// \brief Bytes reserved in front of the buffer
+///
+/// Lets a transport put its control byte right before the data it sends, so the buffer never has to be copied.
+#define FRAMEBUFFER_PREFIX 1
+
 /// \brief Framebuffer class contains a pointer to buffer and functions for interacting with it
 class FrameBuffer {
+    /// allocation holding prefix followed by buffer
+    unsigned char * storage;
     unsigned char * buffer;
+
+    /// first and last changed column of every page since last call to clearDirty(), first > last means page is clean
+    unsigned char dirtyStart[FRAMEBUFFER_PAGES];
+    unsigned char dirtyEnd[FRAMEBUFFER_PAGES];
+
+    /// Widens dirty column range of the page containing byte n
+    void markDirty(int n);
+
+    /// Widens dirty column range of the page containing bytes n to n + count - 1
+    void markDirty(int n, int count);
 public:
     /// Constructs frame buffer and allocates memory for buffer
     FrameBuffer();
@@ -19,6 +42,10 @@ public:
     /// Destroys frame buffer and frees buffer memory
     ~FrameBuffer();
 
+    /// Buffer memory is owned, copies would free it twice
+    FrameBuffer(const FrameBuffer &) = delete;
+    FrameBuffer &operator=(const FrameBuffer &) = delete;
+
     /// \brief Performs OR logical operation on selected and provided byte
     ///
     /// ex. if byte in buffer at position n is 0b10001111 and provided byte is 0b11110000 the buffer at position n becomes 0b11111111
@@ -40,14 +67,66 @@ public:
     /// \param byte - provided byte to make operation
     void byteXOR(int n, unsigned char byte);
 
-    /// Replaces pointer with one pointing to a different buffer
-    void setBuffer(unsigned char * new_buffer);
+    /// \brief Performs OR logical operation on a run of bytes in one page
+    ///
+    /// A full 0xFF byte is written with memset instead of byte by byte
+    /// \param n - byte offset in buffer array of the first byte
+    /// \param count - number of bytes, all of them have to be in the same page as n
+    /// \param byte - provided byte to make operation
+    void spanOR(int n, int count, unsigned char byte);
+
+    /// \brief Performs AND logical operation on a run of bytes in one page
+    ///
+    /// A 0x00 byte is written with memset instead of byte by byte
+    /// \param n - byte offset in buffer array of the first byte
+    /// \param count - number of bytes, all of them have to be in the same page as n
+    /// \param byte - provided byte to make operation
+    void spanAND(int n, int count, unsigned char byte);
+
+    /// \brief Performs XOR logical operation on a run of bytes in one page
+    /// \param n - byte offset in buffer array of the first byte
+    /// \param count - number of bytes, all of them have to be in the same page as n
+    /// \param byte - provided byte to make operation
+    void spanXOR(int n, int count, unsigned char byte);
+
+    /// \brief Overwrites a run of bytes in one page, only bytes that differ are marked as changed
+    /// \param n - byte offset in buffer array of the first byte
+    /// \param bytes - new content
+    /// \param count - number of bytes, all of them have to be in the same page as n
+    void setBytes(int n, const unsigned char * bytes, int count);
+
+    /// \brief Copies bits selected by mask of a run of bytes from a different 1024 byte buffer, at the same offset
+    ///
+    /// Only bytes that change are marked as changed
+    /// \param n - byte offset in both buffers of the first byte
+    /// \param count - number of bytes, all of them have to be in the same page as n
+    /// \param source - buffer to copy from
+    /// \param mask - bits to take from source, the others are kept
+    void spanCopy(int n, int count, const unsigned char * source, unsigned char mask);
+
+    /// Copies 1024 bytes from a different buffer, the buffer stays owned by the caller
+    void setBuffer(const unsigned char * new_buffer);
 
     /// Zeroes out the buffer aka set buffer to all 0
     void clear();
 
     /// Returns a pointer to the buffer
     unsigned char * get();
+
+    /// Returns a pointer to FRAMEBUFFER_PREFIX spare bytes directly followed by the buffer
+    unsigned char * getPrefixed();
+
+    /// \brief Returns range of columns changed in a page since last clearDirty() call
+    /// \param page - page to query. values 0 - 7
+    /// \param start, end - set to first and last changed column
+    /// \return false if nothing in page changed, start and end are left untouched in that case
+    bool getDirtyColumns(int page, int &start, int &end) const;
+
+    /// Marks whole buffer as changed
+    void markAllDirty();
+
+    /// Marks whole buffer as unchanged, called after buffer was sent to display
+    void clearDirty();
 };
 
 
@@ -1,12 +1,110 @@
 #include "ShapeRenderer.h"
 
+namespace {
+    /// \brief Walks one octant of a circle with the midpoint algorithm
+    ///
+    /// Calls run(a, b, y) for every stretch of points x = a..b sharing the same y, with x going from 0 up to y.
+    /// Rest of the circle follows by mirroring, stretches are turned into spans by the callers.
+    template<typename Run>
+    void walkOctant(int16_t radius, Run run) {
+        int16_t x = 0, y = radius, error = 1 - radius;
+        int16_t start = 0;
+        while (x <= y) {
+            int16_t nextX = x + 1, nextY = y;
+            if (error < 0) {
+                error += 2 * x + 3;
+            } else {
+                error += 2 * (x - y) + 5;
+                nextY--;
+            }
+            if (nextY != y || nextX > nextY) {
+                run(start, x, y);
+                start = nextX;
+            }
+            x = nextX;
+            y = nextY;
+        }
+    }
+
+    /// \brief Outline of a rectangle with quarter circle corners, every pixel is set once
+    ///
+    /// Corner centers are left, top and right, bottom. When they are equal this is a circle.
+    void drawArcs(pico_ssd1306::SSD1306 *ssd1306, int16_t left, int16_t top, int16_t right, int16_t bottom,
+                  int16_t radius, pico_ssd1306::WriteMode mode) {
+        walkOctant(radius, [&](int16_t a, int16_t b, int16_t y) {
+            // top and bottom, a stretch starting at 0 includes the straight edge between the corners
+            auto row = [&](int16_t row) {
+                if (a == 0) {
+                    ssd1306->fillArea(left - b, row, right + b, row, mode);
+                } else {
+                    ssd1306->fillArea(left - b, row, left - a, row, mode);
+                    ssd1306->fillArea(right + a, row, right + b, row, mode);
+                }
+            };
+            row(top - y);
+            if (bottom + y != top - y) row(bottom + y);
+
+            // left and right, the point where x == y was already drawn as part of top and bottom
+            int16_t end = b < y ? b : y - 1;
+            auto column = [&](int16_t column) {
+                if (a == 0) {
+                    ssd1306->fillArea(column, top - end, column, bottom + end, mode);
+                } else if (end >= a) {
+                    ssd1306->fillArea(column, top - end, column, top - a, mode);
+                    ssd1306->fillArea(column, bottom + a, column, bottom + end, mode);
+                }
+            };
+            column(left - y);
+            if (right + y != left - y) column(right + y);
+        });
+    }
+
+    /// \brief Fills a rectangle with quarter circle corners as vertical spans, every pixel is set once
+    ///
+    /// Corner centers are left, top and right, bottom. When they are equal this is a circle.
+    void fillArcs(pico_ssd1306::SSD1306 *ssd1306, int16_t left, int16_t top, int16_t right, int16_t bottom,
+                  int16_t radius, pico_ssd1306::WriteMode mode) {
+        // column at distance offset from the corner centers reaches height rows above and below them
+        auto columns = [&](int16_t offset, int16_t height) {
+            if (offset == 0) {
+                ssd1306->fillArea(left, top - height, right, bottom + height, mode);
+            } else {
+                ssd1306->fillArea(left - offset, top - height, left - offset, bottom + height, mode);
+                ssd1306->fillArea(right + offset, top - height, right + offset, bottom + height, mode);
+            }
+        };
+
+        walkOctant(radius, [&](int16_t a, int16_t b, int16_t y) {
+            for (int16_t x = a; x <= b; x++) columns(x, y);
+            // mirrored column, same as the last one of the stretch when that is on the diagonal
+            if (b != y) columns(y, b);
+        });
+    }
+
+    /// Limits corner radius of a rectangle so that corners do not overlap
+    int16_t cornerRadius(uint8_t x_start, uint8_t y_start, uint8_t x_end, uint8_t y_end, uint8_t radius) {
+        int16_t shorter = abs(x_end - x_start) < abs(y_end - y_start) ? abs(x_end - x_start) : abs(y_end - y_start);
+        return radius < shorter / 2 ? radius : shorter / 2;
+    }
+}
+
 void pico_ssd1306::drawLine(pico_ssd1306::SSD1306 *ssd1306, uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1,
                             pico_ssd1306::WriteMode mode) {
+    // axis aligned lines are a single span
+    if (y0 == y1) {
+        ssd1306->fillArea(x0 < x1 ? x0 : x1, y0, x0 < x1 ? x1 : x0, y0, mode);
+        return;
+    }
+    if (x0 == x1) {
+        ssd1306->fillArea(x0, y0 < y1 ? y0 : y1, x0, y0 < y1 ? y1 : y0, mode);
+        return;
+    }
+
     int x, y, dx, dy, dx0, dy0, px, py, xe, ye, i;
     dx = x1 - x0;
     dy = y1 - y0;
-    dx0 = fabs(dx);
-    dy0 = fabs(dy);
+    dx0 = abs(dx);
+    dy0 = abs(dy);
     px = 2 * dy0 - dx0;
     py = 2 * dx0 - dy0;
     if (dy0 <= dx0) {
@@ -64,17 +162,49 @@ void pico_ssd1306::drawLine(pico_ssd1306::SSD1306 *ssd1306, uint8_t x0, uint8_t
 
 void pico_ssd1306::drawRect(pico_ssd1306::SSD1306 *ssd1306, uint8_t x_start, uint8_t y_start, uint8_t x_end, uint8_t y_end,
                             pico_ssd1306::WriteMode mode) {
-    drawLine(ssd1306, x_start, y_start, x_end, y_start, mode);
-    drawLine(ssd1306, x_start, y_end, x_end, y_end, mode);
-    drawLine(ssd1306, x_start, y_start, x_start, y_end, mode);
-    drawLine(ssd1306, x_end, y_start, x_end, y_end, mode);
+    drawArcs(ssd1306, x_start < x_end ? x_start : x_end, y_start < y_end ? y_start : y_end,
+             x_start < x_end ? x_end : x_start, y_start < y_end ? y_end : y_start, 0, mode);
 }
 
 void pico_ssd1306::fillRect(pico_ssd1306::SSD1306 *ssd1306, uint8_t x_start, uint8_t y_start, uint8_t x_end, uint8_t y_end,
                             pico_ssd1306::WriteMode mode) {
-    for (uint8_t x = x_start; x <= x_end; x++) {
-        for (uint8_t y = y_start; y <= y_end; y++) {
-            ssd1306->setPixel(x, y, mode);
-        }
-    }
+    ssd1306->fillArea(x_start, y_start, x_end, y_end, mode);
+}
+
+void pico_ssd1306::drawCircle(pico_ssd1306::SSD1306 *ssd1306, uint8_t x, uint8_t y, uint8_t radius,
+                              pico_ssd1306::WriteMode mode) {
+    drawArcs(ssd1306, x, y, x, y, radius, mode);
+}
+
+void pico_ssd1306::fillCircle(pico_ssd1306::SSD1306 *ssd1306, uint8_t x, uint8_t y, uint8_t radius,
+                              pico_ssd1306::WriteMode mode) {
+    fillArcs(ssd1306, x, y, x, y, radius, mode);
+}
+
+void pico_ssd1306::drawRoundRect(pico_ssd1306::SSD1306 *ssd1306, uint8_t x_start, uint8_t y_start, uint8_t x_end,
+                                 uint8_t y_end, uint8_t radius, pico_ssd1306::WriteMode mode) {
+    if (x_end < x_start || y_end < y_start) return;
+    int16_t r = cornerRadius(x_start, y_start, x_end, y_end, radius);
+    drawArcs(ssd1306, x_start + r, y_start + r, x_end - r, y_end - r, r, mode);
+}
+
+void pico_ssd1306::fillRoundRect(pico_ssd1306::SSD1306 *ssd1306, uint8_t x_start, uint8_t y_start, uint8_t x_end,
+                                 uint8_t y_end, uint8_t radius, pico_ssd1306::WriteMode mode) {
+    if (x_end < x_start || y_end < y_start) return;
+    int16_t r = cornerRadius(x_start, y_start, x_end, y_end, radius);
+    fillArcs(ssd1306, x_start + r, y_start + r, x_end - r, y_end - r, r, mode);
+}
+
+void pico_ssd1306::drawProgressBar(pico_ssd1306::SSD1306 *ssd1306, uint8_t x_start, uint8_t y_start, uint8_t x_end,
+                                   uint8_t y_end, uint16_t value, uint16_t max) {
+    drawRect(ssd1306, x_start, y_start, x_end, y_end);
+
+    int16_t left = x_start + 2, right = x_end - 2;
+    if (right < left || y_end < y_start + 4) return;
+
+    if (value > max) value = max;
+    int16_t filled = max ? (int32_t) (right - left + 1) * value / max : 0;
+
+    ssd1306->fillArea(left, y_start + 2, left + filled - 1, y_end - 2);
+    ssd1306->fillArea(left + filled, y_start + 2, right, y_end - 2, pico_ssd1306::WriteMode::SUBTRACT);
 }
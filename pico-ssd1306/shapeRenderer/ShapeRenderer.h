@@ -1,13 +1,13 @@
 #ifndef SSD1306_SHAPERENDERER_H
 #define SSD1306_SHAPERENDERER_H
 
-#include <math.h>
+#include <stdlib.h>
 #include "../ssd1306.h"
 
 namespace pico_ssd1306{
 
     /// \brief Draws a line from x0, y0 to x1, y1.
-    /// It supports all drawing angles
+    /// It supports all drawing angles, horizontal and vertical lines are drawn as a single span
     /// \param ssd1306 - is the pointer to a SSD1306 object aka an initialised display
     /// \param x0, y0, x1, y1 are the start and end coordinates between which the line will be drawn
     /// \param mode - mode describes setting behavior. See WriteMode doc for more information
@@ -22,6 +22,39 @@ namespace pico_ssd1306{
     /// \param x_start, x_end, y_start, y_end - corner points for the rectangle
     /// \param mode - mode describes setting behavior. See WriteMode doc for more information
     void fillRect (pico_ssd1306::SSD1306 *ssd1306 , uint8_t x_start, uint8_t y_start, uint8_t x_end, uint8_t y_end, pico_ssd1306::WriteMode mode = pico_ssd1306::WriteMode::ADD);
+
+    /// \brief Draws a 1px wide circle
+    /// \param x, y - center of the circle
+    /// \param radius - radius in pixels, 0 draws a single pixel
+    /// \param mode - mode describes setting behavior. See WriteMode doc for more information
+    void drawCircle (pico_ssd1306::SSD1306 *ssd1306, uint8_t x, uint8_t y, uint8_t radius, pico_ssd1306::WriteMode mode = pico_ssd1306::WriteMode::ADD);
+
+    /// \brief Fills a circle
+    /// \param x, y - center of the circle
+    /// \param radius - radius in pixels, 0 draws a single pixel
+    /// \param mode - mode describes setting behavior. See WriteMode doc for more information
+    void fillCircle (pico_ssd1306::SSD1306 *ssd1306, uint8_t x, uint8_t y, uint8_t radius, pico_ssd1306::WriteMode mode = pico_ssd1306::WriteMode::ADD);
+
+    /// \brief Draws a 1px wide rectangle with rounded corners
+    /// \param x_start, x_end, y_start, y_end - corner points for the rectangle
+    /// \param radius - corner radius, limited to half of the shorter side
+    /// \param mode - mode describes setting behavior. See WriteMode doc for more information
+    void drawRoundRect (pico_ssd1306::SSD1306 *ssd1306, uint8_t x_start, uint8_t y_start, uint8_t x_end, uint8_t y_end, uint8_t radius, pico_ssd1306::WriteMode mode = pico_ssd1306::WriteMode::ADD);
+
+    /// \brief Fills a rectangle with rounded corners
+    /// \param x_start, x_end, y_start, y_end - corner points for the rectangle
+    /// \param radius - corner radius, limited to half of the shorter side
+    /// \param mode - mode describes setting behavior. See WriteMode doc for more information
+    void fillRoundRect (pico_ssd1306::SSD1306 *ssd1306, uint8_t x_start, uint8_t y_start, uint8_t x_end, uint8_t y_end, uint8_t radius, pico_ssd1306::WriteMode mode = pico_ssd1306::WriteMode::ADD);
+
+    /// \brief Draws a horizontal progress bar, an outline with a bar growing from the left inside of it
+    ///
+    /// The part of the inside past the bar is cleared, so the bar can be redrawn in place as value changes.
+    /// Outline and inside are 1px apart.
+    /// \param x_start, x_end, y_start, y_end - corner points for the outline
+    /// \param value - progress, clamped to max
+    /// \param max - value at which bar is full
+    void drawProgressBar (pico_ssd1306::SSD1306 *ssd1306, uint8_t x_start, uint8_t y_start, uint8_t x_end, uint8_t y_end, uint16_t value, uint16_t max);
 }
 
 #endif //SSD1306_SHAPERENDERER_H
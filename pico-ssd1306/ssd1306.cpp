@@ -1,23 +1,42 @@
 #include "ssd1306.h"
+#include "hardware/irq.h"
+#include "DmaIrq.hpp"
 
 namespace pico_ssd1306 {
+    /// worst case stream: every page gets its own window of 7 command words, 1 control word and its data
+    static constexpr int TX_STREAM_SIZE = FRAMEBUFFER_PAGES * 8 + FRAMEBUFFER_SIZE;
+
+    SSD1306 *SSD1306::i2cSenders[NUM_I2CS];
+
     SSD1306::SSD1306(i2c_inst *i2CInst, uint16_t Address, Size size) {
         // Set class instanced variables
         this->i2CInst = i2CInst;
         this->address = Address;
-        this->size = size;
-
-        this->width = 128;
 
+        // only place the size is looked at, drawing goes through the primitives of this size from now on
         if (size == Size::W128xH32) {
-            this->height = 32;
+            this->canvas = &PanelCanvas<Size::W128xH32>::functions;
         } else {
-            this->height = 64;
+            this->canvas = &PanelCanvas<Size::W128xH64>::functions;
         }
 
         // display is not inverted by default
         this->inverted = false;
 
+        this->scrollCommandsLength = 0;
+
+        // display RAM content is unknown until first full buffer is sent
+        this->panelBuffer = new unsigned char[FRAMEBUFFER_SIZE];
+        this->panelValid = false;
+
+        // DMA resources are only taken once sendBufferAsync is used
+        this->txStream = nullptr;
+        this->dmaChannel = -1;
+        this->sendCallback = nullptr;
+        this->sendCallbackData = nullptr;
+        this->sending = false;
+        this->sendFailed = false;
+
         // this is a list of setup commands for the display
         uint8_t setup[] = {
                 SSD1306_DISPLAY_OFF,
@@ -58,10 +77,8 @@ namespace pico_ssd1306 {
                 SSD1306_DISPLAY_ON
         };
 
-        // send each one of the setup commands
-        for (uint8_t &command: setup) {
-            this->cmd(command);
-        }
+        // send all setup commands in one transaction
+        this->cmdList(setup, sizeof(setup));
 
         // clear the buffer and send it to the display
         // if not done display shows garbage data
@@ -70,55 +87,270 @@ namespace pico_ssd1306 {
 
     }
 
+    SSD1306::~SSD1306() {
+        if (this->dmaChannel >= 0) {
+            this->waitForSend();
+            DmaIrq::detach(this->dmaChannel);
+            dma_channel_unclaim(this->dmaChannel);
+        }
+        delete[] this->txStream;
+        delete[] this->panelBuffer;
+    }
+
     void SSD1306::setPixel(int16_t x, int16_t y, WriteMode mode) {
-        // return if position out of bounds
-        if ((x < 0) || (x >= this->width) || (y < 0) || (y >= this->height)) return;
+        this->canvas->setPixel(this->frameBuffer, x, y, mode);
+    }
 
-        // byte to be used for buffer operation
-        uint8_t byte;
+    int SSD1306::collectWindows(Window *windows) {
+        unsigned char *buffer = this->frameBuffer.get();
+        int count = 0;
 
-        // display with 32 px height requires doubling of set bits, reason to this is explained in readme
-        // this shifts 1 to byte based on y coordinate
-        // remember that buffer is a one dimension array, so we have to calculate offset from coordinates
-        if (size == Size::W128xH32) {
-            y = (y << 1) + 1;
-            byte = 1 << (y & 7);
-            char byte_offset = byte >> 1;
-            byte = byte | byte_offset;
-        } else {
-            byte = 1 << (y & 7);
-        }
+        // display RAM is unknown, every page has to be sent
+        if (!this->panelValid) this->frameBuffer.markAllDirty();
 
-        // check the write mode and manipulate the frame buffer
-        if (mode == WriteMode::ADD) {
-            this->frameBuffer.byteOR(x + (y / 8) * this->width, byte);
-        } else if (mode == WriteMode::SUBTRACT) {
-            this->frameBuffer.byteAND(x + (y / 8) * this->width, ~byte);
-        } else if (mode == WriteMode::INVERT) {
-            this->frameBuffer.byteXOR(x + (y / 8) * this->width, byte);
+        for (int page = 0; page < FRAMEBUFFER_PAGES; page++) {
+            int start, end;
+            if (!this->frameBuffer.getDirtyColumns(page, start, end)) continue;
+
+            int offset = page * FRAMEBUFFER_WIDTH;
+
+            // narrow the range down to bytes that actually differ from display RAM
+            if (this->panelValid) {
+                while (start <= end && buffer[offset + start] == this->panelBuffer[offset + start]) start++;
+                while (end >= start && buffer[offset + end] == this->panelBuffer[offset + end]) end--;
+                if (start > end) continue;
+            }
+
+            memcpy(this->panelBuffer + offset + start, buffer + offset + start, end - start + 1);
+
+            // consecutive pages changed over the whole width are contiguous in the buffer and go out as one window
+            bool fullWidth = start == 0 && end == FRAMEBUFFER_WIDTH - 1;
+            if (fullWidth && count > 0) {
+                Window &last = windows[count - 1];
+                if (last.columnStart == 0 && last.columnEnd == FRAMEBUFFER_WIDTH - 1 && last.pageEnd == page - 1) {
+                    last.pageEnd = page;
+                    continue;
+                }
+            }
+
+            windows[count++] = {(uint8_t) page, (uint8_t) page, (uint8_t) start, (uint8_t) end};
         }
 
+        this->frameBuffer.clearDirty();
+        this->panelValid = true;
+        return count;
+    }
+
+    void SSD1306::setColumn(int16_t x, int16_t y, uint32_t bits, uint8_t count, WriteMode mode) {
+        this->canvas->setColumn(this->frameBuffer, x, y, bits, count, mode);
+    }
+
+    void SSD1306::setPageBytes(int16_t x, int16_t y, const uint8_t *bytes, uint8_t count, WriteMode mode) {
+        this->canvas->setPageBytes(this->frameBuffer, x, y, bytes, count, mode);
+    }
+
+    void SSD1306::copyPageBytes(int16_t x, int16_t y, const uint8_t *bytes, uint8_t count) {
+        this->canvas->copyPageBytes(this->frameBuffer, x, y, bytes, count);
+    }
 
+    void SSD1306::fillArea(int16_t x0, int16_t y0, int16_t x1, int16_t y1, WriteMode mode) {
+        this->canvas->fillArea(this->frameBuffer, x0, y0, x1, y1, mode);
     }
 
     void SSD1306::sendBuffer() {
-        this->cmd(SSD1306_PAGEADDR); //Set page address from min to max
-        this->cmd(0x00);
-        this->cmd(0x07);
-        this->cmd(SSD1306_COLUMNADDR); //Set column address from min to max
-        this->cmd(0x00);
-        this->cmd(127);
+        this->waitForSend();
+
+        Window windows[FRAMEBUFFER_PAGES];
+        int count = this->collectWindows(windows);
+
+        // scroll has moved display RAM around and RAM may not be written while scrolling
+        bool resumeScroll = count > 0 && this->scrollCommandsLength > 0;
+        if (resumeScroll) {
+            this->cmd(SSD1306_DEACTIVATE_SCROLL);
+            this->panelValid = false;
+            this->frameBuffer.markAllDirty();
+            count = this->collectWindows(windows);
+        }
 
-        // create a temporary buffer of size of buffer plus 1 byte for startline command aka 0x40
-        unsigned char data[FRAMEBUFFER_SIZE + 1];
+        this->sendFailed = false;
+        for (int i = 0; i < count; i++) {
+            const Window &window = windows[i];
+            this->setAddressWindow(window.pageStart, window.pageEnd, window.columnStart, window.columnEnd);
+            if (!this->sendData(window.pageStart * FRAMEBUFFER_WIDTH + window.columnStart,
+                                (window.pageEnd - window.pageStart + 1) * (window.columnEnd - window.columnStart + 1))) {
+                // display is missing or did not answer, whatever it got is sent again next time
+                this->sendFailed = true;
+                this->panelValid = false;
+                break;
+            }
+        }
 
-        data[0] = SSD1306_STARTLINE;
+        if (resumeScroll) this->cmdList(this->scrollCommands, this->scrollCommandsLength);
+    }
+
+    void SSD1306::sendBufferAsync() {
+        this->waitForSend();
+
+        // restarting a scroll has to happen after the data went out, which only the blocking path does
+        if (this->scrollCommandsLength > 0) {
+            this->sendBuffer();
+            if (this->sendCallback) this->sendCallback(this->sendCallbackData);
+            return;
+        }
+
+        Window windows[FRAMEBUFFER_PAGES];
+        int count = this->collectWindows(windows);
+        if (count == 0) {
+            if (this->sendCallback) this->sendCallback(this->sendCallbackData);
+            return;
+        }
+
+        i2c_hw_t *hw = i2c_get_hw(this->i2CInst);
+        uint index = i2c_hw_index(this->i2CInst);
+
+        if (this->dmaChannel < 0) {
+            this->txStream = new uint16_t[TX_STREAM_SIZE];
+            this->dmaChannel = dma_claim_unused_channel(true);
+            DmaIrq::attach(this->dmaChannel, dmaIrqHandler, this);
+        }
+
+        // shared, other code may still add handlers of its own to the i2c interrupt
+        static bool i2cIrqInstalled[NUM_I2CS];
+        if (!i2cIrqInstalled[index]) {
+            hw->intr_mask = 0;
+            irq_add_shared_handler(I2C0_IRQ + index, i2cIrqHandler, PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY);
+            irq_set_enabled(I2C0_IRQ + index, true);
+            i2cIrqInstalled[index] = true;
+        }
+
+        // every window is two i2c transactions, one with address commands and one with data,
+        // STOP bit on the last word of each ends the transaction and the controller starts the next one by itself
+        unsigned char *buffer = this->frameBuffer.get();
+        int n = 0;
+        for (int i = 0; i < count; i++) {
+            const Window &window = windows[i];
+            this->txStream[n++] = 0x00;
+            this->txStream[n++] = SSD1306_PAGEADDR;
+            this->txStream[n++] = window.pageStart;
+            this->txStream[n++] = window.pageEnd;
+            this->txStream[n++] = SSD1306_COLUMNADDR;
+            this->txStream[n++] = window.columnStart;
+            this->txStream[n++] = window.columnEnd | I2C_IC_DATA_CMD_STOP_BITS;
+
+            this->txStream[n++] = SSD1306_STARTLINE;
+            int width = window.columnEnd - window.columnStart + 1;
+            for (int page = window.pageStart; page <= window.pageEnd; page++) {
+                const unsigned char *row = buffer + page * FRAMEBUFFER_WIDTH + window.columnStart;
+                for (int column = 0; column < width; column++) {
+                    this->txStream[n++] = row[column];
+                }
+            }
+            this->txStream[n - 1] |= I2C_IC_DATA_CMD_STOP_BITS;
+        }
+
+        // target address is normally set by i2c_write_blocking, DMA writes straight to the data register
+        hw->enable = 0;
+        hw->tar = this->address;
+        hw->enable = 1;
+
+        // stale interrupts of blocking transfers are cleared, a missing acknowledge ends the transfer right away,
+        // the final STOP is only waited for once DMA queued the last word
+        hw->clr_tx_abrt;
+        hw->clr_stop_det;
+        this->sending = true;
+        this->sendFailed = false;
+        i2cSenders[index] = this;
+        hw->intr_mask = I2C_IC_INTR_MASK_M_TX_ABRT_BITS;
+
+        dma_channel_config config = dma_channel_get_default_config(this->dmaChannel);
+        channel_config_set_transfer_data_size(&config, DMA_SIZE_16);
+        channel_config_set_read_increment(&config, true);
+        channel_config_set_write_increment(&config, false);
+        channel_config_set_dreq(&config, i2c_get_dreq(this->i2CInst, true));
+        dma_channel_configure(this->dmaChannel, &config, &hw->data_cmd, this->txStream, n, true);
+    }
+
+    bool SSD1306::isSendBusy() {
+        return this->sending;
+    }
+
+    bool SSD1306::lastSendFailed() const {
+        return this->sendFailed;
+    }
+
+    void SSD1306::waitForSend() {
+        while (this->isSendBusy()) tight_loop_contents();
+    }
+
+    void SSD1306::setSendCallback(SendCallback callback, void *userData) {
+        this->sendCallback = callback;
+        this->sendCallbackData = userData;
+    }
+
+    void SSD1306::dmaIrqHandler(uint channel, void *userData) {
+        SSD1306 *display = (SSD1306 *) userData;
+
+        // transfer was already aborted by i2c
+        if (!display->sending) return;
 
-        // copy framebuffer to temporary buffer
-        memcpy(data + 1, frameBuffer.get(), FRAMEBUFFER_SIZE);
+        // DMA is done once the last word is queued, i2c still has to clock out its fifo
+        i2c_get_hw(display->i2CInst)->intr_mask = I2C_IC_INTR_MASK_M_TX_ABRT_BITS | I2C_IC_INTR_MASK_M_STOP_DET_BITS;
+    }
+
+    void SSD1306::i2cIrqHandler() {
+        for (uint index = 0; index < NUM_I2CS; index++) {
+            SSD1306 *display = i2cSenders[index];
+            if (!display) continue;
+
+            i2c_hw_t *hw = i2c_get_hw(display->i2CInst);
+            uint32_t pending = hw->intr_stat;
+
+            if (pending & I2C_IC_INTR_STAT_R_TX_ABRT_BITS) {
+                // controller flushed its fifo and keeps it flushed until the abort is cleared, DMA is stopped first
+                dma_channel_abort(display->dmaChannel);
+                dma_channel_acknowledge_irq0(display->dmaChannel);
+                hw->clr_tx_abrt;
+                display->finishSend(true);
+            } else if (pending & I2C_IC_INTR_STAT_R_STOP_DET_BITS) {
+                hw->clr_stop_det;
+
+                // STOP of an earlier window, words of the following ones are still in the fifo
+                uint32_t status = hw->status;
+                if (!(status & I2C_IC_STATUS_TFE_BITS) || (status & I2C_IC_STATUS_MST_ACTIVITY_BITS)) continue;
+                display->finishSend(false);
+            }
+        }
+    }
+
+    void SSD1306::finishSend(bool failed) {
+        i2c_get_hw(this->i2CInst)->intr_mask = 0;
+        i2cSenders[i2c_hw_index(this->i2CInst)] = nullptr;
+
+        // display RAM is unknown after an abort, next flush sends everything
+        if (failed) this->panelValid = false;
+        this->sendFailed = failed;
+        this->sending = false;
+
+        if (this->sendCallback) this->sendCallback(this->sendCallbackData);
+    }
+
+    void SSD1306::setAddressWindow(uint8_t pageStart, uint8_t pageEnd, uint8_t columnStart, uint8_t columnEnd) {
+        const unsigned char commands[] = {SSD1306_PAGEADDR, pageStart, pageEnd, SSD1306_COLUMNADDR, columnStart, columnEnd};
+        this->cmdList(commands, sizeof(commands));
+    }
+
+    bool SSD1306::sendData(uint16_t offset, uint16_t length) {
+        // byte in front of the data is either the spare prefix byte or the end of the previous page
+        unsigned char *data = this->frameBuffer.getPrefixed() + offset;
+        unsigned char saved = data[0];
+
+        data[0] = SSD1306_STARTLINE;
 
         // send data to device
-        i2c_write_blocking(this->i2CInst, this->address, data, FRAMEBUFFER_SIZE + 1, false);
+        int written = i2c_write_blocking(this->i2CInst, this->address, data, length + 1, false);
+
+        data[0] = saved;
+        return written == length + 1;
     }
 
     void SSD1306::clear() {
@@ -128,11 +360,11 @@ namespace pico_ssd1306 {
     void SSD1306::setOrientation(bool orientation) {
         // remap columns and rows scan direction, effectively flipping the image on display
         if (orientation) {
-            this->cmd(SSD1306_CLUMN_REMAP_OFF);
-            this->cmd(SSD1306_COM_REMAP_OFF);
+            const unsigned char commands[] = {SSD1306_CLUMN_REMAP_OFF, SSD1306_COM_REMAP_OFF};
+            this->cmdList(commands, sizeof(commands));
         } else {
-            this->cmd(SSD1306_CLUMN_REMAP_ON);
-            this->cmd(SSD1306_COM_REMAP_ON);
+            const unsigned char commands[] = {SSD1306_CLUMN_REMAP_ON, SSD1306_COM_REMAP_ON};
+            this->cmdList(commands, sizeof(commands));
         }
     }
 
@@ -140,19 +372,30 @@ namespace pico_ssd1306 {
     SSD1306::addBitmapImage(int16_t anchorX, int16_t anchorY, uint8_t image_width, uint8_t image_height,
                             uint8_t *image,
                             WriteMode mode) {
-        uint8_t byte;
-        // goes over every single bit in image and sets pixel data on its coordinates
-        for (uint8_t y = 0; y < image_height; y++) {
-            for (uint8_t x = 0; x < image_width / 8; x++) {
-                byte = image[y * (image_width / 8) + x];
-                for (uint8_t z = 0; z < 8; z++) {
-                    if ((byte >> (7 - z)) & 1) {
-                        this->setPixel(x * 8 + z + anchorX, y + anchorY, mode);
-                    }
+        // rows are padded to whole bytes, see PageImage.h
+        uint8_t stride = (image_width + 7) / 8;
+
+        // gathers up to 32 rows of a column and sets them together, one byte of frame buffer at a time
+        for (uint16_t y = 0; y < image_height; y += 32) {
+            uint8_t rows = image_height - y < 32 ? image_height - y : 32;
+            for (uint8_t x = 0; x < image_width; x++) {
+                const uint8_t *source = image + y * stride + x / 8;
+                uint8_t bit = 7 - (x & 7);
+                uint32_t bits = 0;
+                for (uint8_t row = 0; row < rows; row++) {
+                    bits |= (uint32_t) ((source[row * stride] >> bit) & 1) << row;
                 }
+                if (bits) this->setColumn(x + anchorX, y + anchorY, bits, rows, mode);
             }
         }
+    }
 
+    void SSD1306::addPageImage(int16_t anchorX, int16_t anchorY, uint8_t image_width, uint8_t image_height,
+                               const uint8_t *image, WriteMode mode) {
+        uint8_t pages = (image_height + 7) / 8;
+        for (uint8_t page = 0; page < pages; page++) {
+            this->setPageBytes(anchorX, anchorY + page * 8, image + page * image_width, image_width, mode);
+        }
     }
 
     void SSD1306::invertDisplay() {
@@ -161,21 +404,106 @@ namespace pico_ssd1306 {
     }
 
     void SSD1306::cmd(unsigned char command) {
+        // i2c fifo may still be busy with a frame from sendBufferAsync
+        this->waitForSend();
+
         // 0x00 is a byte indicating to ssd1306 that a command is being sent
         uint8_t data[2] = {0x00, command};
         i2c_write_blocking(this->i2CInst, this->address, data, 2, false);
     }
 
+    void SSD1306::cmdList(const unsigned char *commands, uint8_t count) {
+        // i2c fifo may still be busy with a frame from sendBufferAsync
+        this->waitForSend();
+
+        // single 0x00 control byte in front of the whole list
+        uint8_t data[256];
+        data[0] = 0x00;
+        memcpy(data + 1, commands, count);
+        i2c_write_blocking(this->i2CInst, this->address, data, count + 1, false);
+    }
+
 
     void SSD1306::setContrast(unsigned char contrast) {
-        this->cmd(SSD1306_CONTRAST);
-        this->cmd(contrast);
+        const unsigned char commands[] = {SSD1306_CONTRAST, contrast};
+        this->cmdList(commands, sizeof(commands));
     }
 
-    void SSD1306::setBuffer(unsigned char * buffer) {
+    void SSD1306::setBuffer(const unsigned char * buffer) {
         this->frameBuffer.setBuffer(buffer);
     }
 
+    void SSD1306::copyBuffer(unsigned char *buffer) {
+        memcpy(buffer, this->frameBuffer.get(), FRAMEBUFFER_SIZE);
+    }
+
+    void SSD1306::restoreArea(const unsigned char *buffer, int16_t x0, int16_t y0, int16_t x1, int16_t y1) {
+        this->canvas->restoreArea(this->frameBuffer, buffer, x0, y0, x1, y1);
+    }
+
+    bool SSD1306::startHorizontalScroll(ScrollDirection direction, int16_t y0, int16_t y1, ScrollSpeed speed) {
+        uint8_t pageStart, pageEnd;
+        if (!this->canvas->scrollPages(y0, y1, pageStart, pageEnd)) return false;
+
+        // scroll setup may only be changed while scroll is deactivated
+        const unsigned char commands[] = {
+                SSD1306_DEACTIVATE_SCROLL,
+                (unsigned char) (SSD1306_RIGHT_HORIZONTAL_SCROLL | (unsigned char) direction),
+                0x00,
+                pageStart,
+                (unsigned char) speed,
+                pageEnd,
+                0x00,
+                0xFF,
+                SSD1306_ACTIVATE_SCROLL,
+        };
+        memcpy(this->scrollCommands, commands, sizeof(commands));
+        this->scrollCommandsLength = sizeof(commands);
+        this->cmdList(this->scrollCommands, this->scrollCommandsLength);
+        return true;
+    }
+
+    bool SSD1306::startDiagonalScroll(ScrollDirection direction, int16_t y0, int16_t y1, uint8_t verticalOffset,
+                                      ScrollSpeed speed) {
+        uint8_t pageStart, pageEnd;
+        if (!this->canvas->scrollPages(y0, y1, pageStart, pageEnd)) return false;
+
+        // rows are doubled on 32 px display
+        verticalOffset *= this->canvas->rowScale;
+
+        const unsigned char commands[] = {
+                SSD1306_DEACTIVATE_SCROLL,
+                SSD1306_VERTICAL_SCROLL_AREA,
+                0x00,
+                FRAMEBUFFER_PAGES * 8,
+                (unsigned char) (SSD1306_VERTICAL_RIGHT_HORIZONTAL_SCROLL + (unsigned char) direction),
+                0x00,
+                pageStart,
+                (unsigned char) speed,
+                pageEnd,
+                (unsigned char) (verticalOffset & 0x3F),
+                SSD1306_ACTIVATE_SCROLL,
+        };
+        memcpy(this->scrollCommands, commands, sizeof(commands));
+        this->scrollCommandsLength = sizeof(commands);
+        this->cmdList(this->scrollCommands, this->scrollCommandsLength);
+        return true;
+    }
+
+    void SSD1306::stopScroll() {
+        if (this->scrollCommandsLength == 0) return;
+        this->scrollCommandsLength = 0;
+        this->cmd(SSD1306_DEACTIVATE_SCROLL);
+
+        // display RAM content was shifted by the scroll and has to be rewritten
+        this->panelValid = false;
+        this->frameBuffer.markAllDirty();
+    }
+
+    bool SSD1306::isScrolling() const {
+        return this->scrollCommandsLength > 0;
+    }
+
     void SSD1306::turnOff() {
         this->cmd(SSD1306_DISPLAY_OFF);
     }
@@ -184,4 +512,130 @@ namespace pico_ssd1306 {
         this->cmd(SSD1306_DISPLAY_ON);
     }
 
+
+    template<Size S>
+    void PanelCanvas<S>::applySpan(FrameBuffer &frameBuffer, int n, int count, uint8_t byte, WriteMode mode) {
+        if (mode == WriteMode::ADD) {
+            frameBuffer.spanOR(n, count, byte);
+        } else if (mode == WriteMode::SUBTRACT) {
+            frameBuffer.spanAND(n, count, ~byte);
+        } else if (mode == WriteMode::INVERT) {
+            frameBuffer.spanXOR(n, count, byte);
+        }
+    }
+
+    template<Size S>
+    bool PanelCanvas<S>::clipArea(int16_t &x0, int16_t &x1, int16_t y0, int16_t y1, int &firstRow, int &lastRow) {
+        if (x0 < 0) x0 = 0;
+        if (y0 < 0) y0 = 0;
+        if (x1 >= Geometry::width) x1 = Geometry::width - 1;
+        if (y1 >= Geometry::height) y1 = Geometry::height - 1;
+        if ((x1 < x0) || (y1 < y0)) return false;
+
+        // display RAM rows, on 32 px display every row is doubled, see setPixel
+        firstRow = y0 * Geometry::rowScale;
+        lastRow = y1 * Geometry::rowScale + Geometry::rowScale - 1;
+        return true;
+    }
+
+    template<Size S>
+    void PanelCanvas<S>::setPageBytes(FrameBuffer &frameBuffer, int16_t x, int16_t y, const uint8_t *bytes,
+                                      uint8_t count, WriteMode mode) {
+        if ((y <= -8) || (y >= Geometry::height)) return;
+
+        // rows on 32 px display are doubled, see setPixel
+        if constexpr (S == Size::W128xH32) {
+            for (uint8_t i = 0; i < count; i++) {
+                setColumn(frameBuffer, x + i, y, bytes[i], 8, mode);
+            }
+            return;
+        }
+
+        int first = x < 0 ? -x : 0;
+        int last = count < Geometry::width - x ? count : Geometry::width - x;
+
+        // arithmetic shift puts rows above the display into page -1
+        int page = y >> 3;
+        uint8_t shift = y & 7;
+        int pages = Geometry::height / 8;
+
+        for (int i = first; i < last; i++) {
+            uint8_t byte = bytes[i];
+            if (!byte) continue;
+
+            int column = x + i;
+            uint8_t upper = byte << shift;
+            uint8_t lower = byte >> (8 - shift);
+            if (page >= 0 && upper) applyByte(frameBuffer, column + page * Geometry::width, upper, mode);
+            if (shift && lower && page + 1 < pages) {
+                applyByte(frameBuffer, column + (page + 1) * Geometry::width, lower, mode);
+            }
+        }
+    }
+
+    template<Size S>
+    void PanelCanvas<S>::copyPageBytes(FrameBuffer &frameBuffer, int16_t x, int16_t y, const uint8_t *bytes,
+                                       uint8_t count) {
+        if ((y <= -8) || (y >= Geometry::height)) return;
+
+        // rows of 32 px display are doubled and unaligned rows span two pages, both take the slow way
+        if (S == Size::W128xH32 || (y & 7) != 0) {
+            fillArea(frameBuffer, x, y, x + count - 1, y + 7, WriteMode::SUBTRACT);
+            setPageBytes(frameBuffer, x, y, bytes, count, WriteMode::ADD);
+            return;
+        }
+
+        int first = x < 0 ? -x : 0;
+        int last = count < Geometry::width - x ? count : Geometry::width - x;
+        if (first >= last) return;
+
+        frameBuffer.setBytes(x + first + (y >> 3) * FRAMEBUFFER_WIDTH, bytes + first, last - first);
+    }
+
+    template<Size S>
+    void PanelCanvas<S>::fillArea(FrameBuffer &frameBuffer, int16_t x0, int16_t y0, int16_t x1, int16_t y1,
+                                  WriteMode mode) {
+        int firstRow, lastRow;
+        if (!clipArea(x0, x1, y0, y1, firstRow, lastRow)) return;
+
+        int count = x1 - x0 + 1;
+        for (int page = firstRow >> 3; page <= lastRow >> 3; page++) {
+            uint8_t byte = 0xFF;
+            if (page == firstRow >> 3) byte &= 0xFF << (firstRow & 7);
+            if (page == lastRow >> 3) byte &= 0xFF >> (7 - (lastRow & 7));
+            applySpan(frameBuffer, x0 + page * FRAMEBUFFER_WIDTH, count, byte, mode);
+        }
+    }
+
+    template<Size S>
+    void PanelCanvas<S>::restoreArea(FrameBuffer &frameBuffer, const unsigned char *buffer, int16_t x0, int16_t y0,
+                                     int16_t x1, int16_t y1) {
+        int firstRow, lastRow;
+        if (!clipArea(x0, x1, y0, y1, firstRow, lastRow)) return;
+
+        int count = x1 - x0 + 1;
+        for (int page = firstRow >> 3; page <= lastRow >> 3; page++) {
+            uint8_t mask = 0xFF;
+            if (page == firstRow >> 3) mask &= 0xFF << (firstRow & 7);
+            if (page == lastRow >> 3) mask &= 0xFF >> (7 - (lastRow & 7));
+            frameBuffer.spanCopy(x0 + page * FRAMEBUFFER_WIDTH, count, buffer, mask);
+        }
+    }
+
+    template<Size S>
+    bool PanelCanvas<S>::scrollPages(int16_t y0, int16_t y1, uint8_t &pageStart, uint8_t &pageEnd) {
+        if ((y0 < 0) || (y1 < y0) || (y1 >= Geometry::height)) return false;
+
+        // display RAM rows, on 32 px display every row is doubled, see setPixel
+        int firstRow = y0 * Geometry::rowScale;
+        int lastRow = y1 * Geometry::rowScale + Geometry::rowScale - 1;
+        if ((firstRow & 7) != 0 || (lastRow & 7) != 7) return false;
+
+        pageStart = firstRow >> 3;
+        pageEnd = lastRow >> 3;
+        return true;
+    }
+
+    template class PanelCanvas<Size::W128xH64>;
+    template class PanelCanvas<Size::W128xH32>;
 }
@@ -3,7 +3,9 @@
 
 #include <string.h>
 #include "hardware/i2c.h"
+#include "hardware/dma.h"
 #include "frameBuffer/FrameBuffer.h"
+#include "PageImage.h"
 
 namespace pico_ssd1306 {
     /// Register addresses from datasheet
@@ -35,6 +37,13 @@ namespace pico_ssd1306 {
         SSD1306_CLUMN_REMAP_OFF = 0xA0,
         SSD1306_CLUMN_REMAP_ON = 0xA1,
         SSD1306_CHARGEPUMP = 0x8D,
+        SSD1306_RIGHT_HORIZONTAL_SCROLL = 0x26,
+        SSD1306_LEFT_HORIZONTAL_SCROLL = 0x27,
+        SSD1306_VERTICAL_RIGHT_HORIZONTAL_SCROLL = 0x29,
+        SSD1306_VERTICAL_LEFT_HORIZONTAL_SCROLL = 0x2A,
+        SSD1306_DEACTIVATE_SCROLL = 0x2E,
+        SSD1306_ACTIVATE_SCROLL = 0x2F,
+        SSD1306_VERTICAL_SCROLL_AREA = 0xA3,
         SSD1306_EXTERNALVCC = 0x1,
         SSD1306_SWITCHCAPVCC = 0x2,
     };
@@ -57,24 +66,234 @@ namespace pico_ssd1306 {
         INVERT = 2,
     };
 
+    /// \enum pico_ssd1306::ScrollDirection
+    enum class ScrollDirection : const unsigned char{
+        /// content moves to the right
+        RIGHT = 0,
+        /// content moves to the left
+        LEFT = 1,
+    };
+
+    /// \enum pico_ssd1306::ScrollSpeed
+    /// \brief Number of display frames between two 1 px scroll steps, values are the codes from datasheet
+    enum class ScrollSpeed : const unsigned char{
+        FRAMES_2 = 0b111,
+        FRAMES_3 = 0b100,
+        FRAMES_4 = 0b101,
+        FRAMES_5 = 0b000,
+        FRAMES_25 = 0b110,
+        FRAMES_64 = 0b001,
+        FRAMES_128 = 0b010,
+        FRAMES_256 = 0b011,
+    };
+
+    /// \struct pico_ssd1306::PanelGeometry
+    /// \brief Compile time pixel addressing of a display size
+    ///
+    /// offset gives frame buffer byte of a pixel and mask the bits to change in it.
+    /// 32 px displays double every row, so a pixel there is two bits of a byte and rowScale display RAM rows.
+    template<Size S>
+    struct PanelGeometry;
+
+    template<>
+    struct PanelGeometry<Size::W128xH64> {
+        static constexpr uint8_t width = 128;
+        static constexpr uint8_t height = 64;
+        static constexpr uint8_t rowScale = 1;
+
+        static constexpr int offset(int16_t x, int16_t y) { return x + (y >> 3) * width; }
+
+        static constexpr uint8_t mask(int16_t y) { return 1 << (y & 7); }
+    };
+
+    template<>
+    struct PanelGeometry<Size::W128xH32> {
+        static constexpr uint8_t width = 128;
+        static constexpr uint8_t height = 32;
+        static constexpr uint8_t rowScale = 2;
+
+        static constexpr int offset(int16_t x, int16_t y) { return x + (y >> 2) * width; }
+
+        static constexpr uint8_t mask(int16_t y) { return 0b11 << ((y & 3) << 1); }
+    };
+
+    /// \struct pico_ssd1306::CanvasFunctions
+    /// \brief Drawing primitives of one display size, SSD1306 picks the table of its size once when constructed
+    struct CanvasFunctions {
+        void (*setPixel)(FrameBuffer &frameBuffer, int16_t x, int16_t y, WriteMode mode);
+        void (*setColumn)(FrameBuffer &frameBuffer, int16_t x, int16_t y, uint32_t bits, uint8_t count, WriteMode mode);
+        void (*setPageBytes)(FrameBuffer &frameBuffer, int16_t x, int16_t y, const uint8_t *bytes, uint8_t count,
+                             WriteMode mode);
+        void (*copyPageBytes)(FrameBuffer &frameBuffer, int16_t x, int16_t y, const uint8_t *bytes, uint8_t count);
+        void (*fillArea)(FrameBuffer &frameBuffer, int16_t x0, int16_t y0, int16_t x1, int16_t y1, WriteMode mode);
+        void (*restoreArea)(FrameBuffer &frameBuffer, const unsigned char *buffer, int16_t x0, int16_t y0, int16_t x1,
+                            int16_t y1);
+        bool (*scrollPages)(int16_t y0, int16_t y1, uint8_t &pageStart, uint8_t &pageEnd);
+        /// display RAM rows per pixel row
+        uint8_t rowScale;
+    };
+
+    /// \class PanelCanvas ssd1306.h "pico-ssd1306/ssd1306.h"
+    /// \brief Drawing primitives of SSD1306 on a frame buffer, specialized for display size S at compile time
+    ///
+    /// Row doubling of 32 px displays and display bounds are resolved by the compiler, so none of these test
+    /// the size. SSD1306 forwards its drawing calls to the PanelCanvas of its size, see the matching
+    /// SSD1306 methods for what each one does. setPixel and setColumn are inline, the rest is instantiated for
+    /// both sizes in ssd1306.cpp.
+    template<Size S>
+    class PanelCanvas {
+        typedef PanelGeometry<S> Geometry;
+
+        /// \brief Applies byte to frame buffer according to write mode
+        /// \param n - byte offset in frame buffer
+        /// \param byte - pixels to change
+        /// \param mode - mode describes setting behavior. See WriteMode doc for more information
+        static void applyByte(FrameBuffer &frameBuffer, int n, uint8_t byte, WriteMode mode);
+
+        /// \brief Applies the same byte to a run of bytes in one page according to write mode
+        /// \param n - byte offset in frame buffer of the first byte
+        /// \param count - number of bytes, all in the same page
+        /// \param byte - pixels to change in every byte
+        /// \param mode - mode describes setting behavior. See WriteMode doc for more information
+        static void applySpan(FrameBuffer &frameBuffer, int n, int count, uint8_t byte, WriteMode mode);
+
+        /// \brief Applies bits to one column of frame buffer a byte at a time
+        /// \param x - column to change
+        /// \param row - frame buffer bit row matching bit 0 of bits, already mapped to display RAM rows
+        /// \param bits - bits to apply, at most 32
+        /// \param mode - mode describes setting behavior. See WriteMode doc for more information
+        static void applyColumn(FrameBuffer &frameBuffer, int16_t x, int16_t row, uint32_t bits, WriteMode mode);
+
+        /// \brief Clips rectangle to the display and maps its rows to display RAM rows
+        /// \return false if nothing of it is on the display
+        static bool clipArea(int16_t &x0, int16_t &x1, int16_t y0, int16_t y1, int &firstRow, int &lastRow);
+
+    public:
+        static void setPixel(FrameBuffer &frameBuffer, int16_t x, int16_t y, WriteMode mode);
+
+        static void setColumn(FrameBuffer &frameBuffer, int16_t x, int16_t y, uint32_t bits, uint8_t count,
+                              WriteMode mode);
+
+        static void setPageBytes(FrameBuffer &frameBuffer, int16_t x, int16_t y, const uint8_t *bytes, uint8_t count,
+                                 WriteMode mode);
+
+        static void copyPageBytes(FrameBuffer &frameBuffer, int16_t x, int16_t y, const uint8_t *bytes, uint8_t count);
+
+        static void fillArea(FrameBuffer &frameBuffer, int16_t x0, int16_t y0, int16_t x1, int16_t y1, WriteMode mode);
+
+        static void restoreArea(FrameBuffer &frameBuffer, const unsigned char *buffer, int16_t x0, int16_t y0,
+                                int16_t x1, int16_t y1);
+
+        /// \brief Maps rows to display RAM pages for scroll commands
+        /// \return false if rows do not cover whole pages
+        static bool scrollPages(int16_t y0, int16_t y1, uint8_t &pageStart, uint8_t &pageEnd);
+
+        /// Table of the functions above for SSD1306
+        static const CanvasFunctions functions;
+    };
+
+    template<Size S>
+    const CanvasFunctions PanelCanvas<S>::functions = {
+            &PanelCanvas<S>::setPixel,
+            &PanelCanvas<S>::setColumn,
+            &PanelCanvas<S>::setPageBytes,
+            &PanelCanvas<S>::copyPageBytes,
+            &PanelCanvas<S>::fillArea,
+            &PanelCanvas<S>::restoreArea,
+            &PanelCanvas<S>::scrollPages,
+            PanelGeometry<S>::rowScale,
+    };
+
+    /// \brief Callback type for sendBufferAsync completion, called from i2c interrupt
+    typedef void (*SendCallback)(void *userData);
+
     /// \class SSD1306 ssd1306.h "pico-ssd1306/ssd1306.h"
     /// \brief SSD1306 class represents i2c connection to display
     class SSD1306 {
     private:
         i2c_inst *i2CInst;
         uint16_t address;
-        Size size;
 
-        FrameBuffer frameBuffer;
+        /// drawing primitives of the display size, see PanelCanvas
+        const CanvasFunctions *canvas;
+
+        /// copy of what display RAM currently holds, used to skip bytes that did not change since last flush
+        unsigned char *panelBuffer;
+
+        /// false until the whole buffer was sent once, display RAM holds garbage before that
+        bool panelValid;
+
+        /// \brief Part of display RAM to be rewritten, either a single page or a run of full width pages
+        struct Window {
+            uint8_t pageStart, pageEnd, columnStart, columnEnd;
+        };
+
+        /// front buffer for sendBufferAsync, holds IC_DATA_CMD words ready to be fed to i2c by DMA
+        uint16_t *txStream;
+
+        /// DMA channel feeding txStream to i2c, -1 until first sendBufferAsync call
+        int dmaChannel;
+
+        SendCallback sendCallback;
+        void *sendCallbackData;
+
+        /// true from sendBufferAsync until i2c saw the final STOP or aborted the transfer
+        volatile bool sending;
+
+        /// display did not acknowledge the last flush
+        volatile bool sendFailed;
 
-        uint8_t width, height;
+        /// display whose sendBufferAsync transfer runs on each i2c controller, looked up by i2cIrqHandler
+        static SSD1306 *i2cSenders[NUM_I2CS];
+
+        /// \brief Finds changed parts of frame buffer and updates copy of display RAM as if they were already sent
+        /// \param windows - array of at least FRAMEBUFFER_PAGES windows to be filled
+        /// \return number of windows filled
+        int collectWindows(Window *windows);
+
+        /// Called through DmaIrq once the last word of the frame was queued, starts waiting for the final STOP
+        static void dmaIrqHandler(uint channel, void *userData);
+
+        /// Shared handler of both i2c interrupts, finishes transfers that stopped or were aborted
+        static void i2cIrqHandler();
+
+        /// Ends a sendBufferAsync transfer, a failed one leaves the whole display to be sent again
+        void finishSend(bool failed);
 
         bool inverted;
 
+        /// commands that started the running hardware scroll, kept to restart it after display RAM was rewritten
+        unsigned char scrollCommands[12];
+
+        /// length of scrollCommands, 0 when display is not scrolling
+        uint8_t scrollCommandsLength;
+
         /// \brief Sends single 8bit command to ssd1306 controller
         /// \param command - byte to be sent to controller
         void cmd(unsigned char command);
 
+        /// \brief Sends a list of commands in a single i2c transaction
+        ///
+        /// Control byte with continuation bit cleared is sent once, so every following byte is read as a command.
+        /// \param commands - bytes to be sent to controller
+        /// \param count - number of bytes
+        void cmdList(const unsigned char *commands, uint8_t count);
+
+        /// \brief Sets display RAM window that following data bytes are written to
+        /// \param pageStart, pageEnd - first and last page of the window. values 0 - 7
+        /// \param columnStart, columnEnd - first and last column of the window. values 0 - 127
+        void setAddressWindow(uint8_t pageStart, uint8_t pageEnd, uint8_t columnStart, uint8_t columnEnd);
+
+        /// \brief Sends part of frame buffer as display data
+        ///
+        /// Control byte is written into the byte just before the data and put back afterwards, so nothing is copied
+        /// \param offset - byte offset in frame buffer of the first byte to send
+        /// \param length - number of bytes to send
+        /// \return false if display did not acknowledge
+        bool sendData(uint16_t offset, uint16_t length);
+
+        FrameBuffer frameBuffer;
+
     public:
         /// \brief SSD1306 constructor initialized display and sets all required registers for operation
         /// \param i2CInst - i2c instance. Either i2c0 or i2c1
@@ -82,6 +301,13 @@ namespace pico_ssd1306 {
         /// \param size - display size. Acceptable values W128xH32 or W128xH64
         SSD1306(i2c_inst *i2CInst, uint16_t Address, Size size);
 
+        /// Waits for running transfer and frees the copy of display RAM and DMA resources
+        ~SSD1306();
+
+        /// Display owns its buffers and DMA channel, so it cannot be copied
+        SSD1306(const SSD1306 &) = delete;
+        SSD1306 &operator=(const SSD1306 &) = delete;
+
         /// \brief Set pixel operates frame buffer
         /// x is the x position of pixel you want to change. values 0 - 127
         /// y is the y position of pixel you want to change. values 0 - 31 or 0 - 63
@@ -90,10 +316,111 @@ namespace pico_ssd1306 {
         /// \param mode - mode describes setting behavior. See WriteMode doc for more information
         void setPixel(int16_t x, int16_t y, WriteMode mode = WriteMode::ADD);
 
+        /// \brief Sets up to 32 vertically stacked pixels of one column at once
+        ///
+        /// Bits are applied a whole buffer byte at a time, shifted across page boundary when y is not a multiple of 8.
+        /// Pixels outside of the display are clipped.
+        /// \param x - column to change. values 0 - 127
+        /// \param y - position of the pixel matching bit 0 of bits
+        /// \param bits - pixel data, bit 0 is the topmost pixel, only set bits are applied
+        /// \param count - number of pixels in bits. values 0 - 32
+        /// \param mode - mode describes setting behavior. See WriteMode doc for more information
+        void setColumn(int16_t x, int16_t y, uint32_t bits, uint8_t count, WriteMode mode = WriteMode::ADD);
+
+        /// \brief Puts a row of 8 pixel tall column bytes, laid out like display RAM, into frame buffer
+        ///
+        /// With y being a multiple of 8 every byte goes into the buffer as is, otherwise it is split across two pages.
+        /// Pixels outside of the display are clipped.
+        /// \param x, y - position of top left pixel of the row
+        /// \param bytes - one byte per column, bit 0 is the topmost pixel, only set bits are applied
+        /// \param count - number of bytes
+        /// \param mode - mode describes setting behavior. See WriteMode doc for more information
+        void setPageBytes(int16_t x, int16_t y, const uint8_t *bytes, uint8_t count, WriteMode mode = WriteMode::ADD);
+
+        /// \brief Sets every pixel of a rectangle, including its edges
+        ///
+        /// Each page the rectangle touches gets one byte mask applied to the whole run of columns,
+        /// pages covered completely are memset. Pixels outside of the display are clipped.
+        /// Nothing is drawn when x1 < x0 or y1 < y0.
+        /// \param x0, y0 - top left corner
+        /// \param x1, y1 - bottom right corner
+        /// \param mode - mode describes setting behavior. See WriteMode doc for more information
+        void fillArea(int16_t x0, int16_t y0, int16_t x1, int16_t y1, WriteMode mode = WriteMode::ADD);
+
+        /// \brief Replaces a row of 8 pixel tall columns with bytes laid out like display RAM
+        ///
+        /// Unlike setPageBytes every pixel of the row is written, so nothing has to be cleared first.
+        /// With y being a multiple of 8 on a 128x64 display the bytes are copied straight into the frame buffer
+        /// and only bytes that actually differ are marked as changed. Pixels outside of the display are clipped.
+        /// \param x, y - position of top left pixel of the row
+        /// \param bytes - one byte per column, bit 0 is the topmost pixel
+        /// \param count - number of bytes
+        void copyPageBytes(int16_t x, int16_t y, const uint8_t *bytes, uint8_t count);
+
         /// \brief Sends frame buffer to display so that it updated
+        ///
+        /// Only columns that changed since the previous call are sent, each changed page gets its own address window.
+        /// If nothing changed no bytes are sent at all.
         void sendBuffer();
 
+        /// \brief Starts sending frame buffer to display in the background and returns right away
+        ///
+        /// Changed parts of the buffer are encoded into a separate front buffer which DMA feeds to i2c,
+        /// so drawing into the frame buffer can go on while the transfer runs.
+        /// If a previous transfer is still running this waits for it first.
+        void sendBufferAsync();
+
+        /// \brief Checks whether a transfer started by sendBufferAsync is still running
+        /// \return true until i2c controller sent the final STOP or gave up on a missing acknowledge
+        bool isSendBusy();
+
+        /// \brief Checks whether display failed to acknowledge the last sendBuffer or sendBufferAsync
+        ///
+        /// Display RAM is unknown after a failed flush, so the next one sends the whole buffer again.
+        bool lastSendFailed() const;
+
+        /// Blocks until transfer started by sendBufferAsync is finished
+        void waitForSend();
+
+        /// \brief Sets function to be called from i2c interrupt when a sendBufferAsync transfer ended
+        ///
+        /// It is also called when the transfer was aborted, see lastSendFailed.
+        /// When there is nothing to send the callback is called directly from sendBufferAsync
+        /// \param callback - function to call, nullptr to disable
+        /// \param userData - pointer passed to callback
+        void setSendCallback(SendCallback callback, void *userData = nullptr);
+
+        /// \brief Starts continuous hardware scroll of a band of the display
+        ///
+        /// Content of the band rotates around horizontally with no i2c traffic per step. Display RAM may not be
+        /// written while scrolling, so sendBuffer and sendBufferAsync stop the scroll, rewrite the whole display
+        /// and start the scroll again from its initial position when the frame buffer changed.
+        /// \param direction - direction content moves in
+        /// \param y0, y1 - first and last row of the band, they have to cover whole display RAM pages,
+        /// ie. 8 rows on 128x64 and 4 rows on 128x32 display
+        /// \param speed - frames between scroll steps
+        /// \return false if rows do not cover whole pages, nothing is sent in that case
+        bool startHorizontalScroll(ScrollDirection direction, int16_t y0, int16_t y1, ScrollSpeed speed = ScrollSpeed::FRAMES_5);
+
+        /// \brief Starts continuous hardware scroll that moves the band horizontally and the whole display vertically
+        /// \param direction - direction content of the band moves in
+        /// \param y0, y1 - first and last row of the band, see startHorizontalScroll
+        /// \param speed - frames between scroll steps
+        /// \param verticalOffset - rows the display moves up every step. values 1 - 63
+        /// \return false if rows do not cover whole pages, nothing is sent in that case
+        bool startDiagonalScroll(ScrollDirection direction, int16_t y0, int16_t y1, uint8_t verticalOffset,
+                                 ScrollSpeed speed = ScrollSpeed::FRAMES_5);
+
+        /// \brief Stops hardware scroll, display is fully rewritten by the next sendBuffer or sendBufferAsync call
+        void stopScroll();
+
+        /// \brief Checks whether hardware scroll is running
+        bool isScrolling() const;
+
         /// \brief Adds bitmap image to frame buffer
+        ///
+        /// Every row of image is (image_width + 7) / 8 bytes, most significant bit being the leftmost pixel,
+        /// the same layout makePageImage takes.
         /// \param anchorX - sets start point of where to put the image on the screen
         /// \param anchorY - sets start point of where to put the image on the screen
         /// \param image_width - width of the image in pixels
@@ -103,9 +430,44 @@ namespace pico_ssd1306 {
         void addBitmapImage(int16_t anchorX, int16_t anchorY, uint8_t image_width, uint8_t image_height, uint8_t *image,
                             WriteMode mode = WriteMode::ADD);
 
+        /// \brief Adds an image laid out like display RAM to frame buffer
+        ///
+        /// Every page of the image is put in as whole bytes, shifted across two pages when anchorY is not
+        /// a multiple of 8. Pixels outside of the display are clipped.
+        /// \param anchorX, anchorY - position of top left pixel of the image
+        /// \param image_width - width of the image in pixels
+        /// \param image_height - height of the image in pixels
+        /// \param image - (image_height + 7) / 8 pages of image_width bytes, see PageImage.
+        /// Rows below image_height in the last page have to be 0
+        /// \param mode - mode describes setting behavior. See WriteMode doc for more information
+        void addPageImage(int16_t anchorX, int16_t anchorY, uint8_t image_width, uint8_t image_height,
+                          const uint8_t *image, WriteMode mode = WriteMode::ADD);
+
+        /// \brief Adds a PageImage to frame buffer, see addPageImage
+        template<uint8_t Width, uint8_t Height>
+        void addPageImage(int16_t anchorX, int16_t anchorY, const PageImage<Width, Height> &image,
+                          WriteMode mode = WriteMode::ADD) {
+            this->addPageImage(anchorX, anchorY, Width, Height, image.data, mode);
+        }
+
         /// \brief Manually set frame buffer. make sure it's correct size of 1024 bytes
+        ///
+        /// Buffer content is copied, the buffer stays owned by the caller
         /// \param buffer - pointer to a new buffer
-        void setBuffer(unsigned char *buffer);
+        void setBuffer(const unsigned char *buffer);
+
+        /// \brief Copies frame buffer content into a different 1024 byte buffer
+        /// \param buffer - buffer to copy into
+        void copyBuffer(unsigned char *buffer);
+
+        /// \brief Copies a rectangle, including its edges, from a different 1024 byte buffer in frame buffer layout
+        ///
+        /// Pixels outside of the rectangle are left alone and only bytes that change are sent by the next flush.
+        /// Used to put back the background of a widget from a Layer.
+        /// \param buffer - buffer to copy from, e.g. filled by copyBuffer
+        /// \param x0, y0 - top left corner
+        /// \param x1, y1 - bottom right corner
+        void restoreArea(const unsigned char *buffer, int16_t x0, int16_t y0, int16_t x1, int16_t y1);
 
         /// \brief Flips the display
         /// \param orientation - 0 for not flipped, 1 for flipped display
@@ -129,6 +491,78 @@ namespace pico_ssd1306 {
         void turnOn();
     };
 
+    template<Size S>
+    inline void PanelCanvas<S>::applyByte(FrameBuffer &frameBuffer, int n, uint8_t byte, WriteMode mode) {
+        if (mode == WriteMode::ADD) {
+            frameBuffer.byteOR(n, byte);
+        } else if (mode == WriteMode::SUBTRACT) {
+            frameBuffer.byteAND(n, ~byte);
+        } else if (mode == WriteMode::INVERT) {
+            frameBuffer.byteXOR(n, byte);
+        }
+    }
+
+    template<Size S>
+    inline void PanelCanvas<S>::applyColumn(FrameBuffer &frameBuffer, int16_t x, int16_t row, uint32_t bits,
+                                            WriteMode mode) {
+        // up to 32 bits shifted by up to 7 span at most 5 pages
+        uint64_t shifted = (uint64_t) bits << (row & 7);
+        int n = x + (row / 8) * Geometry::width;
+
+        while (shifted) {
+            uint8_t byte = shifted & 0xFF;
+            if (byte) applyByte(frameBuffer, n, byte, mode);
+            shifted >>= 8;
+            n += Geometry::width;
+        }
+    }
+
+    template<Size S>
+    inline void PanelCanvas<S>::setPixel(FrameBuffer &frameBuffer, int16_t x, int16_t y, WriteMode mode) {
+        // negative positions wrap around to large unsigned values, so one compare per axis is enough
+        if (((uint16_t) x >= Geometry::width) || ((uint16_t) y >= Geometry::height)) return;
+
+        applyByte(frameBuffer, Geometry::offset(x, y), Geometry::mask(y), mode);
+    }
+
+    template<Size S>
+    inline void PanelCanvas<S>::setColumn(FrameBuffer &frameBuffer, int16_t x, int16_t y, uint32_t bits, uint8_t count,
+                                          WriteMode mode) {
+        if (((uint16_t) x >= Geometry::width) || (count == 0)) return;
+
+        // clip pixels above and below the display
+        if (y < 0) {
+            if (-y >= count) return;
+            bits >>= -y;
+            count += y;
+            y = 0;
+        }
+        if (y + count > Geometry::height) {
+            if (y >= Geometry::height) return;
+            count = Geometry::height - y;
+        }
+        if (count < 32) bits &= (1u << count) - 1;
+        if (!bits) return;
+
+        if constexpr (S == Size::W128xH32) {
+            // every row is doubled, 16 rows fill 32 display RAM rows at a time
+            while (bits) {
+                uint32_t doubled = bits & 0xFFFF;
+                doubled = (doubled | doubled << 8) & 0x00FF00FF;
+                doubled = (doubled | doubled << 4) & 0x0F0F0F0F;
+                doubled = (doubled | doubled << 2) & 0x33333333;
+                doubled = (doubled | doubled << 1) & 0x55555555;
+                applyColumn(frameBuffer, x, y << 1, doubled | doubled << 1, mode);
+                bits >>= 16;
+                y += 16;
+            }
+        } else {
+            applyColumn(frameBuffer, x, y, bits, mode);
+        }
+    }
+
+    extern template class PanelCanvas<Size::W128xH64>;
+    extern template class PanelCanvas<Size::W128xH32>;
 }
 
 #endif //SSD1306_SSD1306_H
\ No newline at end of file
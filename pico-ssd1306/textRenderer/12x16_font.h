@@ -3,7 +3,7 @@
 
 #ifndef SSD1306_ASCII_FULL
 
-const unsigned char font_12x16[] = {
+constexpr unsigned char font_12x16[] = {
     0x0C, 0x10, // font width, height
 
     0x0,
@@ -2382,7 +2382,7 @@ const unsigned char font_12x16[] = {
     0x0};
 
 #else
-const unsigned char font_12x16[] = {
+constexpr unsigned char font_12x16[] = {
     0x0C,
     0x10, // font width, height
 
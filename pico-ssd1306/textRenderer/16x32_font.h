@@ -3,7 +3,7 @@
 
 #ifndef SSD1306_ASCII_FULL
 
-const unsigned char font_16x32[] = {
+constexpr unsigned char font_16x32[] = {
         0x10, 0x20, // font width, height
 
         0x0, 0x0,
@@ -3143,7 +3143,7 @@ const unsigned char font_16x32[] = {
 };
 
 #else
-const unsigned char font_16x32[] = {
+constexpr unsigned char font_16x32[] = {
         0x10, 0x20, // font width, height
 
         0x0, 0x0,
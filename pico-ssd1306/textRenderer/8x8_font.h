@@ -3,7 +3,7 @@
 
 #ifndef SSD1306_ASCII_FULL
 
-const unsigned char font_8x8[] = {
+constexpr unsigned char font_8x8[] = {
     0x8, 0x8, // font width, height
 
     0x0,
@@ -862,7 +862,7 @@ const unsigned char font_8x8[] = {
     0x0};
 
 #else
-const unsigned char font_8x8[] = {
+constexpr unsigned char font_8x8[] = {
     0x8,
     0x8, // font width, height
 
@@ -0,0 +1,126 @@
+#include "Marquee.h"
+
+namespace pico_ssd1306 {
+
+    namespace {
+        /// Columns between end of the text and its next repetition in software scroll
+        constexpr uint16_t MARQUEE_GAP = 32;
+
+        /// Milliseconds between software steps, hardware scroll runs at about 10 ms per frame
+        uint16_t stepInterval(ScrollSpeed speed) {
+            switch (speed) {
+                case ScrollSpeed::FRAMES_2:
+                    return 20;
+                case ScrollSpeed::FRAMES_3:
+                    return 30;
+                case ScrollSpeed::FRAMES_4:
+                    return 40;
+                case ScrollSpeed::FRAMES_5:
+                    return 50;
+                case ScrollSpeed::FRAMES_25:
+                    return 250;
+                case ScrollSpeed::FRAMES_64:
+                    return 640;
+                case ScrollSpeed::FRAMES_128:
+                    return 1280;
+                case ScrollSpeed::FRAMES_256:
+                    return 2560;
+            }
+            return 50;
+        }
+    }
+
+    Marquee::Marquee(SSD1306 *ssd1306, const unsigned char *font, ScrollSpeed speed) {
+        this->ssd1306 = ssd1306;
+        this->font = font;
+        this->y = 0;
+        this->speed = speed;
+        this->text[0] = '\0';
+        this->textWidth = 0;
+        this->period = 1;
+        this->offset = 0;
+        this->active = false;
+        this->hardware = false;
+        this->nextStep = get_absolute_time();
+    }
+
+    void Marquee::start(const char *text, int16_t y) {
+        this->stop();
+        if (!this->ssd1306 || !this->font || !text) return;
+
+        strncpy(this->text, text, MARQUEE_TEXT_SIZE - 1);
+        this->text[MARQUEE_TEXT_SIZE - 1] = '\0';
+        this->y = y;
+
+        uint8_t font_height = this->font[1];
+        this->textWidth = strlen(this->text) * this->font[0];
+        // text that fits goes around the display the same way the display rotates its columns when scrolling
+        this->period = this->textWidth <= FRAMEBUFFER_WIDTH ? FRAMEBUFFER_WIDTH : this->textWidth + MARQUEE_GAP;
+        this->offset = 0;
+        this->draw();
+
+        // display can only rotate its 128 columns, so the whole text has to be in them
+        if (this->textWidth <= FRAMEBUFFER_WIDTH) {
+            this->ssd1306->sendBuffer();
+            this->hardware = this->ssd1306->startHorizontalScroll(ScrollDirection::LEFT, this->y,
+                                                                  this->y + font_height - 1, this->speed);
+        }
+
+        this->active = true;
+        this->nextStep = make_timeout_time_ms(stepInterval(this->speed));
+    }
+
+    bool Marquee::step() {
+        if (!this->active || this->hardware || !time_reached(this->nextStep)) return false;
+
+        this->nextStep = delayed_by_ms(this->nextStep, stepInterval(this->speed));
+        this->offset = (this->offset + 1) % this->period;
+        this->draw();
+        return true;
+    }
+
+    void Marquee::stop() {
+        if (this->hardware) this->ssd1306->stopScroll();
+        this->active = false;
+        this->hardware = false;
+    }
+
+    bool Marquee::isActive() const {
+        return this->active;
+    }
+
+    bool Marquee::isHardware() const {
+        return this->hardware;
+    }
+
+    uint32_t Marquee::textColumn(uint16_t column) const {
+        if (column >= this->textWidth) return 0;
+
+        uint8_t font_width = this->font[0];
+        uint8_t column_bytes = this->font[1] / 8;
+        unsigned char c = this->text[column / font_width];
+        if (c < 32) return 0;
+
+        // glyph columns start on byte boundary, see drawCharColumns
+        const unsigned char *glyph = this->font + (c - 32) * font_width * column_bytes + 2;
+        const unsigned char *bytes = glyph + (column % font_width) * column_bytes;
+
+        uint32_t bits = 0;
+        for (uint8_t b = 0; b < column_bytes; b++) {
+            bits |= (uint32_t) bytes[b] << (b * 8);
+        }
+        return bits;
+    }
+
+    void Marquee::draw() {
+        uint8_t font_height = this->font[1];
+        if (font_height % 8 != 0 || font_height > 32) return;
+
+        this->ssd1306->fillArea(0, this->y, FRAMEBUFFER_WIDTH - 1, this->y + font_height - 1, WriteMode::SUBTRACT);
+
+        for (uint16_t x = 0; x < FRAMEBUFFER_WIDTH; x++) {
+            uint32_t bits = this->textColumn((this->offset + x) % this->period);
+            if (bits) this->ssd1306->setColumn(x, this->y, bits, font_height);
+        }
+    }
+}
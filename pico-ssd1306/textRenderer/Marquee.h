@@ -0,0 +1,76 @@
+#ifndef SSD1306_MARQUEE_H
+#define SSD1306_MARQUEE_H
+
+#include "pico/stdlib.h"
+#include "../ssd1306.h"
+
+/// \brief Longest text a Marquee holds, longer text is cut
+#define MARQUEE_TEXT_SIZE 64
+
+namespace pico_ssd1306 {
+
+    /// \class Marquee Marquee.h "pico-ssd1306/textRenderer/Marquee.h"
+    /// \brief Line of text moving from right to left across the whole width of the display
+    ///
+    /// Text that fits the display and sits on whole display RAM pages is scrolled by the display itself,
+    /// there is no i2c traffic while it moves. Nothing else should be drawn in those pages, it would scroll too.
+    /// Any other text is scrolled in software, step() redraws only the rows of the line, so flushing after it
+    /// sends just the pages they cover.
+    class Marquee {
+        SSD1306 *ssd1306;
+        const unsigned char *font;
+        int16_t y;
+        ScrollSpeed speed;
+
+        char text[MARQUEE_TEXT_SIZE];
+        uint16_t textWidth;
+
+        /// columns before text starts again
+        uint16_t period;
+
+        /// column of text shown at the left edge of display
+        uint16_t offset;
+
+        bool active;
+        bool hardware;
+        absolute_time_t nextStep;
+
+        /// Returns pixels of a text column, 0 for columns in the gap
+        uint32_t textColumn(uint16_t column) const;
+
+        /// Clears the rows of the line and draws text shifted by offset
+        void draw();
+
+    public:
+        /// \brief Marquee constructor, nothing is drawn until start is called
+        /// \param ssd1306 - pointer to a SSD1306 object aka initialised display
+        /// \param font - pointer to a font data array, font height has to be a multiple of 8 up to 32
+        /// \param speed - frames between 1 px steps, software scroll steps at roughly the same rate
+        Marquee(SSD1306 *ssd1306, const unsigned char *font, ScrollSpeed speed = ScrollSpeed::FRAMES_5);
+
+        /// \brief Draws text into frame buffer and starts moving it
+        ///
+        /// Text is copied. When the display scrolls it by itself the frame buffer is sent right away with
+        /// sendBuffer, as display RAM has to hold the text before scrolling starts.
+        /// \param text - text to show
+        /// \param y - top row of the line
+        void start(const char *text, int16_t y);
+
+        /// \brief Moves software scrolled text by one column once its step is due
+        ///
+        /// Call it from the main loop as often as convenient.
+        /// \return true if frame buffer changed and should be sent to display
+        bool step();
+
+        /// \brief Stops moving text, text stays in frame buffer where it is
+        void stop();
+
+        /// \brief Checks whether text is moving
+        bool isActive() const;
+
+        /// \brief Checks whether text is scrolled by the display itself
+        bool isHardware() const;
+    };
+}
+
+#endif //SSD1306_MARQUEE_H
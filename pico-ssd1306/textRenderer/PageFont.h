@@ -0,0 +1,86 @@
+#ifndef SSD1306_PAGEFONT_H
+#define SSD1306_PAGEFONT_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+namespace pico_ssd1306 {
+
+    /// \brief Number of character codes covered by PageFont index, codes 32 - 255
+    constexpr uint16_t PAGEFONT_INDEX_SIZE = 224;
+
+    /// \brief Index value of a character not included in PageFont
+    constexpr uint8_t PAGEFONT_MISSING = 0xFF;
+
+    /// \struct pico_ssd1306::PageFont
+    /// \brief Font with glyphs laid out the same way as ssd1306 display RAM, holding only chosen characters
+    ///
+    /// Every glyph is Height / 8 pages, one after another, and every page is Width bytes, one per column with
+    /// bit 0 as the topmost pixel. A page of a glyph can be put into the frame buffer as is.
+    /// Use makePageFont to build one from a font array at compile time.
+    template<uint8_t Width, uint8_t Height, size_t Count>
+    struct PageFont {
+        static constexpr uint8_t width = Width;
+        static constexpr uint8_t height = Height;
+        static constexpr uint8_t pages = Height / 8;
+        static constexpr size_t glyphSize = pages * Width;
+
+        /// glyph number for every character code starting at 32, PAGEFONT_MISSING if glyph is not included
+        uint8_t index[PAGEFONT_INDEX_SIZE];
+
+        /// glyph data
+        uint8_t glyphs[Count][glyphSize];
+
+        /// \brief Looks up a glyph
+        /// \param c - character to look up
+        /// \return pointer to glyph data or nullptr if c is not included
+        constexpr const uint8_t *glyph(char c) const {
+            uint8_t code = c;
+            if (code < 32 || index[code - 32] == PAGEFONT_MISSING) return nullptr;
+            return glyphs[index[code - 32]];
+        }
+    };
+
+    /// \brief Transcodes a font array into a PageFont containing only the given characters
+    ///
+    /// Runs at compile time, so only the resulting glyphs end up in flash and the source font array is dropped
+    /// unless it is used elsewhere. Font height has to be a multiple of 8.
+    ///
+    /// ex. constexpr auto clockFont = makePageFont<font_16x32>("0123456789:");
+    /// \tparam Font - font array, first two bytes are glyph width and height
+    /// \param chars - characters to include
+    template<const unsigned char *Font, size_t N>
+    constexpr PageFont<Font[0], Font[1], N - 1> makePageFont(const char (&chars)[N]) {
+        static_assert(Font[1] % 8 == 0, "font height has to be a multiple of 8");
+        static_assert(Font[0] <= 32 && Font[1] <= 32, "rotated glyphs are drawn through 32 bit rows");
+        static_assert(N - 1 < PAGEFONT_MISSING, "too many characters for a page font");
+
+        constexpr uint8_t width = Font[0];
+        constexpr uint8_t pages = Font[1] / 8;
+
+        PageFont<Font[0], Font[1], N - 1> result{};
+
+        for (uint16_t i = 0; i < PAGEFONT_INDEX_SIZE; i++) {
+            result.index[i] = PAGEFONT_MISSING;
+        }
+
+        for (uint8_t g = 0; g < N - 1; g++) {
+            uint8_t code = chars[g];
+
+            // source glyphs are stored column after column, every column being one byte per page
+            uint16_t seek = (code - 32) * width * pages + 2;
+
+            for (uint8_t x = 0; x < width; x++) {
+                for (uint8_t page = 0; page < pages; page++) {
+                    result.glyphs[g][page * width + x] = Font[seek + x * pages + page];
+                }
+            }
+
+            result.index[code - 32] = g;
+        }
+
+        return result;
+    }
+}
+
+#endif //SSD1306_PAGEFONT_H
@@ -23,6 +23,67 @@ namespace pico_ssd1306 {
         }
     }
 
+    void drawCharColumns(pico_ssd1306::SSD1306 *ssd1306, const unsigned char *glyph, uint8_t font_width, uint8_t font_height,
+                         uint8_t anchor_x, uint8_t anchor_y, WriteMode mode, Rotation rotation) {
+        uint8_t column_bytes = font_height / 8;
+
+        // rotated glyph rows become display columns, so they are collected first
+        uint32_t rows[32] = {};
+
+        for (uint8_t x = 0; x < font_width; x++) {
+            uint32_t column = 0;
+            for (uint8_t b = 0; b < column_bytes; b++) {
+                column |= (uint32_t) glyph[x * column_bytes + b] << (b * 8);
+            }
+            if (!column) continue;
+
+            switch (rotation) {
+                case Rotation::deg0:
+                    ssd1306->setColumn(x + anchor_x, anchor_y, column, font_height, mode);
+                    break;
+                case Rotation::deg90:
+                    for (uint8_t y = 0; y < font_height; y++) {
+                        if (column >> y & 1) rows[y] |= 1u << x;
+                    }
+                    break;
+            }
+        }
+
+        if (rotation == Rotation::deg90) {
+            for (uint8_t y = 0; y < font_height; y++) {
+                if (rows[y]) ssd1306->setColumn(-y + anchor_x + font_height, anchor_y, rows[y], font_width, mode);
+            }
+        }
+    }
+
+    void drawPageGlyph(pico_ssd1306::SSD1306 *ssd1306, const uint8_t *glyph, uint8_t font_width, uint8_t font_height,
+                       uint8_t anchor_x, uint8_t anchor_y, WriteMode mode, Rotation rotation) {
+        uint8_t pages = font_height / 8;
+
+        if (rotation == Rotation::deg0) {
+            for (uint8_t page = 0; page < pages; page++) {
+                ssd1306->setPageBytes(anchor_x, anchor_y + page * 8, glyph + page * font_width, font_width, mode);
+            }
+            return;
+        }
+
+        // rotated glyph rows become display columns
+        uint32_t rows[32] = {};
+
+        for (uint8_t page = 0; page < pages; page++) {
+            for (uint8_t x = 0; x < font_width; x++) {
+                uint8_t byte = glyph[page * font_width + x];
+                for (uint8_t bit = 0; byte; bit++, byte >>= 1) {
+                    if (byte & 1) rows[page * 8 + bit] |= 1u << x;
+                }
+            }
+        }
+
+        for (uint8_t y = 0; y < font_height; y++) {
+            if (rows[y]) ssd1306->setColumn(-y + anchor_x + font_height, anchor_y, rows[y], font_width, mode);
+        }
+    }
+
     void drawChar(pico_ssd1306::SSD1306 *ssd1306, const unsigned char *font, char c, uint8_t anchor_x, uint8_t anchor_y,
                   WriteMode mode, Rotation rotation) {
         if(!ssd1306 || !font || c < 32) return;
@@ -32,6 +93,13 @@ namespace pico_ssd1306 {
 
         uint16_t seek = (c - 32) * (font_width * font_height) / 8 + 2;
 
+        // with height of multiple of 8 every glyph column starts on a byte boundary
+        // and can be put into frame buffer whole bytes at a time, rotated glyphs go through 32 bit rows
+        if (font_height % 8 == 0 && font_height <= 32 && font_width <= 32) {
+            drawCharColumns(ssd1306, font + seek, font_width, font_height, anchor_x, anchor_y, mode, rotation);
+            return;
+        }
+
         uint8_t b_seek = 0;
 
         for (uint8_t x = 0; x < font_width; x++) {
@@ -7,6 +7,7 @@
 #include "8x8_font.h"
 #include "12x16_font.h"
 #include "16x32_font.h"
+#include "PageFont.h"
 
 namespace pico_ssd1306{
 
@@ -27,6 +28,18 @@ namespace pico_ssd1306{
     /// \param rotation - either rotates the char by 90 deg or leaves it unrotated
     void drawChar(pico_ssd1306::SSD1306 *ssd1306, const unsigned char * font, char c, uint8_t anchor_x, uint8_t anchor_y, WriteMode mode = WriteMode::ADD, Rotation rotation = Rotation::deg0);
 
+    /// \brief Draws a glyph of a font with height of multiple of 8 (up to 32) a whole column at a time
+    ///
+    /// Used by drawChar, each glyph column is read as whole bytes and handed to SSD1306::setColumn
+    /// instead of going pixel by pixel.
+    /// \param ssd1306 - pointer to a SSD1306 object aka initialised display
+    /// \param glyph - pointer to the first byte of glyph data inside a font array
+    /// \param font_width, font_height - glyph size in pixels
+    /// \param anchor_x, anchor_y - coordinates setting where to put the glyph
+    /// \param mode - mode describes setting behavior. See WriteMode doc for more information
+    /// \param rotation - either rotates the char by 90 deg or leaves it unrotated
+    void drawCharColumns(pico_ssd1306::SSD1306 *ssd1306, const unsigned char * glyph, uint8_t font_width, uint8_t font_height, uint8_t anchor_x, uint8_t anchor_y, WriteMode mode = WriteMode::ADD, Rotation rotation = Rotation::deg0);
+
     /// \brief Draws text on screen
     /// \param ssd1306 - pointer to a SSD1306 object aka initialised display
     /// \param font - pointer to a font data array
@@ -35,6 +48,78 @@ namespace pico_ssd1306{
     /// \param mode - mode describes setting behavior. See WriteMode doc for more information
     /// \param rotation - either rotates the text by 90 deg or leaves it unrotated
     void drawText(pico_ssd1306::SSD1306 *ssd1306, const unsigned char * font, const char * text, uint8_t anchor_x, uint8_t anchor_y, WriteMode mode = WriteMode::ADD, Rotation rotation = Rotation::deg0);
+
+    /// \brief Draws a single glyph in PageFont layout, every glyph page goes into frame buffer as whole bytes
+    /// \param ssd1306 - pointer to a SSD1306 object aka initialised display
+    /// \param glyph - pointer to glyph data, see PageFont
+    /// \param font_width, font_height - glyph size in pixels
+    /// \param anchor_x, anchor_y - coordinates setting where to put the glyph
+    /// \param mode - mode describes setting behavior. See WriteMode doc for more information
+    /// \param rotation - either rotates the char by 90 deg or leaves it unrotated
+    void drawPageGlyph(pico_ssd1306::SSD1306 *ssd1306, const uint8_t * glyph, uint8_t font_width, uint8_t font_height, uint8_t anchor_x, uint8_t anchor_y, WriteMode mode = WriteMode::ADD, Rotation rotation = Rotation::deg0);
+
+    /// \brief Draws a single glyph of a PageFont on the screen, characters not included in the font are skipped
+    /// \param ssd1306 - pointer to a SSD1306 object aka initialised display
+    /// \param font - page font made with makePageFont
+    /// \param c - char to be drawn
+    /// \param anchor_x, anchor_y - coordinates setting where to put the glyph
+    /// \param mode - mode describes setting behavior. See WriteMode doc for more information
+    /// \param rotation - either rotates the char by 90 deg or leaves it unrotated
+    template<uint8_t Width, uint8_t Height, size_t Count>
+    void drawChar(pico_ssd1306::SSD1306 *ssd1306, const PageFont<Width, Height, Count> &font, char c, uint8_t anchor_x, uint8_t anchor_y, WriteMode mode = WriteMode::ADD, Rotation rotation = Rotation::deg0) {
+        const uint8_t *glyph = font.glyph(c);
+        if (!ssd1306 || !glyph) return;
+        drawPageGlyph(ssd1306, glyph, Width, Height, anchor_x, anchor_y, mode, rotation);
+    }
+
+    /// \brief Replaces a glyph sized cell with a glyph of a PageFont
+    ///
+    /// Every pixel of the cell is written, so it does not have to be cleared first. On a 128x64 display with
+    /// anchor_y being a multiple of 8 the glyph pages are copied into the frame buffer as tiles and only bytes
+    /// that differ are marked as changed, redrawing an unchanged glyph costs nothing when flushing.
+    /// Characters not included in the font leave the cell empty.
+    /// \param ssd1306 - pointer to a SSD1306 object aka initialised display
+    /// \param font - page font made with makePageFont
+    /// \param c - char to be drawn
+    /// \param anchor_x, anchor_y - coordinates setting where to put the glyph
+    template<uint8_t Width, uint8_t Height, size_t Count>
+    void copyChar(pico_ssd1306::SSD1306 *ssd1306, const PageFont<Width, Height, Count> &font, char c, int16_t anchor_x, int16_t anchor_y) {
+        if (!ssd1306) return;
+        const uint8_t *glyph = font.glyph(c);
+        if (!glyph) {
+            ssd1306->fillArea(anchor_x, anchor_y, anchor_x + Width - 1, anchor_y + Height - 1, WriteMode::SUBTRACT);
+            return;
+        }
+        for (uint8_t page = 0; page < Height / 8; page++) {
+            ssd1306->copyPageBytes(anchor_x, anchor_y + page * 8, glyph + page * Width, Width);
+        }
+    }
+
+    /// \brief Draws text on screen using a PageFont
+    /// \param ssd1306 - pointer to a SSD1306 object aka initialised display
+    /// \param font - page font made with makePageFont
+    /// \param text - text to be drawn
+    /// \param anchor_x, anchor_y - coordinates setting where to put the text
+    /// \param mode - mode describes setting behavior. See WriteMode doc for more information
+    /// \param rotation - either rotates the text by 90 deg or leaves it unrotated
+    template<uint8_t Width, uint8_t Height, size_t Count>
+    void drawText(pico_ssd1306::SSD1306 *ssd1306, const PageFont<Width, Height, Count> &font, const char * text, uint8_t anchor_x, uint8_t anchor_y, WriteMode mode = WriteMode::ADD, Rotation rotation = Rotation::deg0) {
+        if (!ssd1306 || !text) return;
+
+        uint16_t n = 0;
+        while (text[n] != '\0') {
+            switch (rotation) {
+                case Rotation::deg0:
+                    drawChar(ssd1306, font, text[n], anchor_x + (n * Width), anchor_y, mode, rotation);
+                    break;
+                case Rotation::deg90:
+                    drawChar(ssd1306, font, text[n], anchor_x, anchor_y + (n * Width), mode, rotation);
+                    break;
+            }
+
+            n++;
+        }
+    }
 }
 
 #endif //SSD1306_TEXTRENDERER_H
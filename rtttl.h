@@ -0,0 +1,313 @@
+#pragma once
+#include <stddef.h>
+#include "buzzer_melodies.h"
+
+// Most notes a melody uploaded at runtime can have, as many as the longest built-in melody and streaming allow
+#define RTTTL_MAX_NOTES BUZZER_STREAM_MAX_NOTES
+#define RTTTL_NAME_SIZE 16
+// Longest RTTTL text taken for a MelodySlot: room for a name and the defaults, every note in its longest form
+// "32c#7." followed by a comma and a space
+#define RTTTL_MAX_TEXT_SIZE (96 + RTTTL_MAX_NOTES * 8)
+
+// Melody held in RAM, eg. parsed from an upload
+struct MelodySlot
+{
+    char name[RTTTL_NAME_SIZE] = {};
+    // terminated by a note of duration 0, like the built-in melodies
+    Note notes[RTTTL_MAX_NOTES + 1] = {};
+    uint16_t length = 0;
+    uint tempo = 0;
+
+    constexpr Melody melody() const
+    {
+        return {notes, tempo};
+    }
+};
+
+// Reads a melody in RTTTL ("name:d=4,o=5,b=100:8e6,8d6,f#5,2p,...") a chunk at a time, so that it can be fed
+// straight from received data without buffering the text. Notes go into a MelodySlot, nothing is allocated.
+// Dotted notes may have the dot before or after the octave. Pitches have to be in NoteFrequencies.
+class RtttlParser
+{
+private:
+    enum class Section
+    {
+        Name,
+        Defaults,
+        Notes,
+        Error
+    };
+
+    MelodySlot *slot = nullptr;
+    Section section = Section::Name;
+    uint8_t name_length = 0;
+
+    uint default_duration = 4;
+    uint default_octave = 6;
+    char key = '\0';
+    uint value = 0;
+
+    // note being read
+    uint duration = 0;
+    char letter = '\0';
+    bool sharp = false;
+    bool dotted = false;
+    int octave = -1;
+
+    constexpr void fail()
+    {
+        section = Section::Error;
+        slot->length = 0;
+    }
+
+    constexpr void applyDefault()
+    {
+        if (key == 'd')
+            default_duration = value;
+        else if (key == 'o')
+            default_octave = value;
+        else if (key == 'b')
+            slot->tempo = value;
+        key = '\0';
+        value = 0;
+    }
+
+    constexpr void resetNote()
+    {
+        duration = 0;
+        letter = '\0';
+        sharp = false;
+        dotted = false;
+        octave = -1;
+    }
+
+    constexpr bool endNote()
+    {
+        if (letter == '\0')
+            return !sharp && !dotted && duration == 0 && octave < 0;
+
+        uint length = duration ? duration : default_duration;
+        if (length == 0 || length > 32 || (length & (length - 1)) != 0 || slot->length == RTTTL_MAX_NOTES)
+            return false;
+
+        uint16_t frequency = NoteFreq::REST;
+        if (letter != 'p')
+        {
+            constexpr int semitones[] = {9, 11, 0, 2, 4, 5, 7, 11};
+            int note_octave = octave >= 0 ? octave : default_octave;
+            // NoteFrequencies starts with a rest and B0, C1 is at 2
+            int index = 2 + (note_octave - 1) * 12 + semitones[letter - 'a'] + (sharp ? 1 : 0);
+            if (index < 1 || index >= (int)(sizeof(NoteFrequencies) / sizeof(NoteFrequencies[0])))
+                return false;
+            frequency = NoteFrequencies[index];
+        }
+
+        slot->notes[slot->length++] = {frequency, (int16_t)(dotted ? -(int)length : (int)length)};
+        resetNote();
+        return true;
+    }
+
+    constexpr void feedNote(char c)
+    {
+        if (c >= 'A' && c <= 'Z')
+            c = c - 'A' + 'a';
+
+        if (c == ',')
+        {
+            if (!endNote())
+                fail();
+        }
+        else if (c >= '0' && c <= '9')
+        {
+            if (letter == '\0')
+                duration = duration * 10 + (c - '0');
+            else if (octave < 0)
+                octave = c - '0';
+            else
+                fail();
+        }
+        else if ((c >= 'a' && c <= 'h') || c == 'p')
+        {
+            if (letter != '\0')
+                fail();
+            else
+                letter = c;
+        }
+        else if (c == '#' && letter != '\0' && letter != 'p' && !sharp && octave < 0)
+            sharp = true;
+        else if (c == '.' && letter != '\0' && !dotted)
+            dotted = true;
+        else
+            fail();
+    }
+
+public:
+    // Starts a new melody in slot, anything in there before is gone
+    constexpr void begin(MelodySlot *slot)
+    {
+        this->slot = slot;
+        section = Section::Name;
+        name_length = 0;
+        default_duration = 4;
+        default_octave = 6;
+        key = '\0';
+        value = 0;
+        resetNote();
+        slot->name[0] = '\0';
+        slot->length = 0;
+        slot->tempo = 63;
+        slot->notes[0] = {NoteFreq::REST, 0};
+    }
+
+    // false once the text turned out not to be valid RTTTL, the rest is ignored then
+    constexpr bool feed(const char *data, size_t length)
+    {
+        for (size_t i = 0; i < length && section != Section::Error; i++)
+        {
+            char c = data[i];
+            if (c == ' ' || c == '\t' || c == '\r' || c == '\n')
+                continue;
+
+            switch (section)
+            {
+            case Section::Name:
+                if (c == ':')
+                    section = Section::Defaults;
+                else if (name_length < RTTTL_NAME_SIZE - 1)
+                {
+                    slot->name[name_length++] = c;
+                    slot->name[name_length] = '\0';
+                }
+                break;
+            case Section::Defaults:
+                if (c == ',' || c == ':')
+                {
+                    applyDefault();
+                    if (c == ':')
+                        section = Section::Notes;
+                }
+                else if (c >= '0' && c <= '9')
+                    value = value * 10 + (c - '0');
+                else if (c != '=')
+                    key = (c >= 'A' && c <= 'Z') ? c - 'A' + 'a' : c;
+                break;
+            case Section::Notes:
+                feedNote(c);
+                break;
+            case Section::Error:
+                break;
+            }
+        }
+        return section != Section::Error;
+    }
+
+    // Ends the melody after the last chunk, true when slot holds a playable melody
+    constexpr bool finish()
+    {
+        if (section != Section::Notes || !endNote() || slot->length == 0 || slot->tempo == 0)
+        {
+            fail();
+            return false;
+        }
+        slot->notes[slot->length] = {NoteFreq::REST, 0};
+        return true;
+    }
+};
+
+// Writes up to count notes, stopping at a note of duration 0, as RTTTL. Returns the length without the
+// terminating '\0' or 0 when it does not fit into size or a frequency is not in NoteFrequencies.
+constexpr size_t writeRtttl(const char *name, const Note *notes, size_t count, uint tempo, char *out, size_t size)
+{
+    constexpr char letters[] = "ccddeffggaab";
+    constexpr bool sharps[] = {false, true, false, true, false, false, true, false, true, false, true, false};
+    size_t n = 0;
+    auto put = [&](char c) {
+        if (n < size)
+            out[n] = c;
+        n++;
+    };
+    auto putNumber = [&](uint number) {
+        char digits[10] = {};
+        int count = 0;
+        do
+        {
+            digits[count++] = '0' + number % 10;
+            number /= 10;
+        } while (number);
+        while (count)
+            put(digits[--count]);
+    };
+
+    for (const char *c = name; *c; c++)
+        put(*c);
+    put(':');
+    put('b');
+    put('=');
+    putNumber(tempo);
+    put(':');
+    for (const Note *note = notes; note < notes + count && note->duration != 0; note++)
+    {
+        if (note != notes)
+            put(',');
+        putNumber(note->duration > 0 ? note->duration : -note->duration);
+        if (note->frequency == NoteFreq::REST)
+            put('p');
+        else
+        {
+            size_t index = 1;
+            while (index < sizeof(NoteFrequencies) / sizeof(NoteFrequencies[0]) && NoteFrequencies[index] != note->frequency)
+                index++;
+            if (index == sizeof(NoteFrequencies) / sizeof(NoteFrequencies[0]))
+                return 0;
+            // index 2 is C1
+            uint semitone = (index + 10) % 12;
+            put(letters[semitone]);
+            if (sharps[semitone])
+                put('#');
+            putNumber((index + 10) / 12);
+        }
+        if (note->duration < 0)
+            put('.');
+    }
+    if (n >= size)
+        return 0;
+    out[n] = '\0';
+    return n;
+}
+
+// True when notes written as RTTTL and parsed again give the same notes, fed in chunks of chunk characters
+template <size_t N>
+constexpr bool rtttlRoundTrip(const Note (&notes)[N], uint tempo, size_t chunk = 7)
+{
+    char text[N * 8 + 32] = {};
+    size_t length = writeRtttl("test", notes, N, tempo, text, sizeof(text));
+    if (length == 0)
+        return false;
+
+    MelodySlot slot;
+    RtttlParser parser;
+    parser.begin(&slot);
+    for (size_t i = 0; i < length; i += chunk)
+        parser.feed(text + i, length - i < chunk ? length - i : chunk);
+    if (!parser.finish() || slot.tempo != tempo)
+        return false;
+
+    size_t count = 0;
+    while (count < N && notes[count].duration != 0)
+        count++;
+    if (slot.length != count)
+        return false;
+    for (size_t i = 0; i < count; i++)
+    {
+        if (slot.notes[i].frequency != notes[i].frequency || slot.notes[i].duration != notes[i].duration)
+            return false;
+    }
+    return true;
+}
+
+static_assert(rtttlRoundTrip(Beep, BeepMelody.tempo) && rtttlRoundTrip(Breeze, BreezeMelody.tempo) &&
+                  rtttlRoundTrip(Rumble, RumbleMelody.tempo) && rtttlRoundTrip(Bzzz, BzzzMelody.tempo) &&
+                  rtttlRoundTrip(DoomNotes, DoomMelody.tempo) && rtttlRoundTrip(RickRollNotes, RickRollMelody.tempo) &&
+                  rtttlRoundTrip(NokiaRingtone, NokiaMelody.tempo) && rtttlRoundTrip(KrabNotes, KrabMelody.tempo) &&
+                  rtttlRoundTrip(PinkPantherNotes, PinkPantherMelody.tempo),
+              "built-in melodies do not survive RTTTL");
@@ -5,8 +5,12 @@
 #include "hardware/gpio.h"
 #include "pico/cyw43_arch.h"
 #include "WS2812.hpp"
+#include "WS2812Effects.hpp"
 #include "pico-ssd1306/ssd1306.h"
 #include "pico-ssd1306/textRenderer/TextRenderer.h"
+#include "pico-ssd1306/compositor/Screen.h"
+#include "pico-ssd1306/compositor/Widgets.h"
+#include "pico-ssd1306/textRenderer/Marquee.h"
 #include "buzzer.h"
 #include "buzzer_melodies.h"
 #include "button.h"
@@ -16,14 +20,29 @@
 
 #define RGBLED_PIN 6
 #define RGBLED_LENGTH 6
+// Colors are given at full level and dimmed by the strip
+#define RGBLED_BRIGHTNESS 128
+// Set to 1 for an idle clock with seconds, HH:MM:SS across the whole display instead of a centered HH:MM
+#ifndef IDLE_CLOCK_SECONDS
+#define IDLE_CLOCK_SECONDS 0
+#endif
 #define LED_PIN 7
 #define BUTTON_PIN 10
 #define BUZZER_PIN 20
+// Loudest the buzzer plays in quiet mode, 0 - 255
+#define BUZZER_QUIET_VOLUME 24
+
+// Glyphs used on screen, transcoded to display page layout at compile time.
+// Only these end up in flash, characters missing from a font are skipped when drawing.
+constexpr auto clockFont = pico_ssd1306::makePageFont<font_16x32>("0123456789:");
+constexpr auto titleFont = pico_ssd1306::makePageFont<font_12x16>(" .-ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz");
+constexpr auto textFont = pico_ssd1306::makePageFont<font_5x8>(" !\"#$%&'()*+,-./0123456789:;<=>?@ABCDEFGHIJKLMNOPQRSTUVWXYZ[\\]^_`abcdefghijklmnopqrstuvwxyz{|}~");
 
 class Scheduler
 {
 private:
-    WS2812 ledStrip;
+    BasicWS2812<RGBLED_LENGTH, WS2812::FORMAT_GRB> ledStrip;
+    BasicWS2812Effects<decltype(ledStrip)> ledEffects;
     Buzzer buzzer;
     Button button;
     pico_ssd1306::SSD1306 display;
@@ -31,73 +50,184 @@ private:
     RTC rtc;
     HTTPServer server;
 
+    // Screens are built once from widgets, a frame only redraws the widgets whose content changed
+    pico_ssd1306::Screen idleScreen;
+    pico_ssd1306::BigClock<decltype(clockFont)> idleClock;
+    pico_ssd1306::Label<decltype(textFont)> idleFooter;
+
+    pico_ssd1306::Screen messageScreen;
+    pico_ssd1306::Label<decltype(titleFont)> messageTitle;
+    pico_ssd1306::Label<decltype(textFont)> messageLines[4];
+    pico_ssd1306::Label<decltype(textFont)> messageFooter;
+    // takes the footer row while shown, so every message line stays readable
+    pico_ssd1306::ProgressBar countdownBar;
+
+    pico_ssd1306::Screen *shownScreen = nullptr;
+
+    // Text line too long for the display scrolls through instead of being cut off
+    pico_ssd1306::Marquee marquee;
+    // Title of a screen that has to catch the eye, it fits the display and sits on whole pages, so the display
+    // scrolls it by itself without any i2c traffic
+    pico_ssd1306::Marquee titleMarquee;
+
+    void BuildScreens()
+    {
+        // fixed text is rasterized once into the background layer of its screen, frames only restore it
+        idleScreen.addStatic(idleFooter);
+        idleScreen.add(idleClock);
+
+        // title only changes when a new message is shown, the footer gives way to the countdown bar
+        messageScreen.addStatic(messageTitle);
+        for (auto &line : messageLines)
+            messageScreen.add(line);
+        messageScreen.add(messageFooter);
+        countdownBar.setVisible(false);
+        messageScreen.add(countdownBar);
+    }
+
+    // Draws changed widgets of a screen, switching screens redraws the new one completely
+    void ShowScreen(pico_ssd1306::Screen &screen)
+    {
+        if (shownScreen != &screen)
+        {
+            display.clear();
+            screen.invalidate();
+            shownScreen = &screen;
+        }
+        screen.render();
+    }
+
     void UpdateIdleDisplay(datetime_t t)
     {
-        char clock_buf[50];
-        snprintf(clock_buf, sizeof(clock_buf), "%02d:%02d", t.hour, t.min);
-        display.clear();
-        drawText(&display, font_16x32, clock_buf, 24, 16);
-        drawText(&display, font_5x8, "Group 7", 46, 56);
-        display.sendBuffer();
+        idleClock.setTime(t.hour, t.min, t.sec);
+        ShowScreen(idleScreen);
+        display.sendBufferAsync();
     }
 
     void UpdateDisplay(const char *title,
                        const char *line1 = "",
                        const char *line2 = "",
                        const char *line3 = "",
-                       const char *line4 = "")
+                       const char *line4 = "",
+                       bool scrollTitle = false)
     {
-        display.clear();
-        drawText(&display, font_12x16, title, 0, 0);
-        if (line1)
-            drawText(&display, font_5x8, line1, 0, 16);
-        if (line2)
-            drawText(&display, font_5x8, line2, 0, 26);
-        if (line3)
-            drawText(&display, font_5x8, line3, 0, 36);
-        if (line4)
-            drawText(&display, font_5x8, line4, 0, 46);
-        drawText(&display, font_5x8, "Group 7", 46, 56);
-        display.sendBuffer();
+        // text left behind by the marquees is only erased by drawing its line again
+        if (marquee.isActive() || titleMarquee.isActive())
+        {
+            marquee.stop();
+            titleMarquee.stop();
+            messageScreen.invalidate();
+        }
+
+        // scrolling title is drawn by its marquee alone
+        messageTitle.setText(scrollTitle ? "" : title);
+        countdownBar.setVisible(false);
+        messageFooter.setVisible(true);
+
+        // only one line can scroll, any further long line is cut off
+        const char *lines[] = {line1, line2, line3, line4};
+        int scrollingLine = -1;
+        for (int i = 0; i < 4; i++)
+        {
+            const char *line = lines[i] ? lines[i] : "";
+            if (scrollingLine < 0 && strlen(line) * textFont.width > FRAMEBUFFER_WIDTH)
+            {
+                scrollingLine = i;
+                line = "";
+            }
+            messageLines[i].setText(line);
+        }
+
+        ShowScreen(messageScreen);
+        if (scrollingLine >= 0)
+            marquee.start(lines[scrollingLine], messageLines[scrollingLine].getBounds().y0);
+        if (scrollTitle)
+            titleMarquee.start(title, messageTitle.getBounds().y0);
+        display.sendBufferAsync();
     }
 
-    void WaitForButtonPress(int timeout_ms = -1)
+    // Moves scrolling text and countdowns along, called from every loop waiting on a screen
+    void AnimateDisplay()
     {
+        bool changed = marquee.step();
+        if (shownScreen && shownScreen->isDirty())
+        {
+            shownScreen->render();
+            changed = true;
+        }
+        if (changed)
+            display.sendBufferAsync();
+    }
+
+    // Returns once the button is pressed or timeout_ms passed. With untilBuzzerDone it waits for the buzzer to
+    // finish its melody instead, timeout_ms is then only the length the countdown shows.
+    void WaitForButtonPress(int timeout_ms = -1, bool showCountdown = false, bool untilBuzzerDone = false)
+    {
+        // bar counts down in 100 ms steps, it is redrawn whenever it shrinks by a pixel
+        if (showCountdown && timeout_ms > 0)
+        {
+            countdownBar.setMax(timeout_ms / 100);
+            countdownBar.setValue(timeout_ms / 100);
+            messageFooter.setVisible(false);
+            countdownBar.setVisible(true);
+        }
+
+        // elapsed time is read from the timer, redrawing the display makes loop passes take longer than 1 ms
+        absolute_time_t start = get_absolute_time();
         int elapsed = 0;
-        while (timeout_ms == -1 || elapsed < timeout_ms)
+        while (untilBuzzerDone ? !buzzer.isDone() : (timeout_ms == -1 || elapsed < timeout_ms))
         {
             sleep_ms(1);
-            elapsed++;
+            elapsed = absolute_time_diff_us(start, get_absolute_time()) / 1000;
+            if (showCountdown && timeout_ms > 0)
+                countdownBar.setValue(elapsed < timeout_ms ? (timeout_ms - elapsed) / 100 : 0);
+            AnimateDisplay();
             if (buttonPressed())
                 break;
         }
     }
 
-    void ActivateLED(uint32_t color)
+    // Effects run from a timer interrupt, this returns right away
+    void ActivateLED(WS2812Effects::Effect effect, uint32_t color, uint period_ms = 1000)
     {
-        ledStrip.fill(color);
-        ledStrip.show();
+        ledEffects.start(effect, color, period_ms);
     }
 
     void ClearLEDAndDisplay()
     {
-        ledStrip.fill(WS2812::RGB(0, 0, 0));
-        ledStrip.show();
+        ledEffects.stop();
+        marquee.stop();
+        titleMarquee.stop();
         display.clear();
-        display.sendBuffer();
+        shownScreen = nullptr;
+        display.sendBufferAsync();
     }
 
 public:
-    Scheduler() : ledStrip(RGBLED_PIN, RGBLED_LENGTH, pio0, 0, WS2812::FORMAT_GRB),
+    Scheduler() : ledStrip(RGBLED_PIN, pio0),
+                  ledEffects(ledStrip),
                   buzzer(BUZZER_PIN),
                   button(BUTTON_PIN),
                   display(i2c_default, 0x3C, pico_ssd1306::Size::W128xH64),
                   wifi(WIFI_SSID, WIFI_PASSWORD),
-                  server()
+                  server(),
+                  idleScreen(&display),
+                  idleClock(clockFont, IDLE_CLOCK_SECONDS ? 0 : 24, 16, IDLE_CLOCK_SECONDS),
+                  idleFooter(textFont, 46, 56, 7, "Group 7"),
+                  messageScreen(&display),
+                  messageTitle(titleFont, 0, 0, 11),
+                  messageLines{{textFont, 0, 16, 25}, {textFont, 0, 26, 25}, {textFont, 0, 36, 25}, {textFont, 0, 46, 25}},
+                  messageFooter(textFont, 46, 56, 7, "Group 7"),
+                  countdownBar(0, 56, 125, 8, 1),
+                  marquee(&display, font_5x8),
+                  titleMarquee(&display, font_12x16)
     {
+        BuildScreens();
         gpio_init(LED_PIN);
         gpio_set_dir(LED_PIN, GPIO_OUT);
         gpio_pull_up(LED_PIN);
+        ledStrip.setBrightness(RGBLED_BRIGHTNESS);
+        buzzer.setStreaming(true);
         display.setOrientation(0);
         ClearLEDAndDisplay();
         cyw43_arch_enable_sta_mode();
@@ -162,18 +292,12 @@ public:
         UpdateDisplay("Conn.Error", "Cannot connect to Wi-Fi", "", "", "Press button to try again");
         printf("Unable to start Scheduler due to Wi-Fi connection failure.\n");
 
-        int brightness = 0;
-        int step = 1; // Controls whether we fade in or out
+        ActivateLED(WS2812Effects::PULSE, WS2812::RGB(0, 0, 255), 1280); // Blue pulse
 
         while (true)
         {
-            brightness += step;
-            // Reverse direction at bounds
-            if (brightness <= 0 || brightness >= 128)
-                step = -step;
-
-            ActivateLED(WS2812::RGB(0, 0, brightness)); // Blue pulse
             sleep_ms(5);
+            AnimateDisplay();
 
             if (buttonPressed())
             {
@@ -192,11 +316,15 @@ public:
 
     void ActivateDeskError()
     {
-        UpdateDisplay("Desk Error", "", "Desk returning error code", "Resolve error to proceed");
-        ActivateLED(WS2812::RGB(128, 0, 0)); // Red
+        // nothing is redrawn while the error is shown, so the scroll runs undisturbed
+        UpdateDisplay("Desk Error", "", "Desk returning error code", "Resolve error to proceed", "", true);
+        ActivateLED(WS2812Effects::BLINK, WS2812::RGB(255, 0, 0)); // Red blink
 
         while (server.get_state() == ServerState::DeskError) // flag needs to be cleared via separate API call
-            sleep_ms(100);
+        {
+            AnimateDisplay();
+            sleep_ms(10);
+        }
 
         ClearLEDAndDisplay();
         server.clear_state();
@@ -223,8 +351,8 @@ public:
     void ActivatePreAlarm(int seconds = 10)
     {
         UpdateDisplay("Warning", "", "Desk alarm will play soon", "Press button to dismiss");
-        ActivateLED(WS2812::RGB(128, 128, 0)); // Yellow
-        WaitForButtonPress(seconds * 1000);
+        ActivateLED(WS2812Effects::PULSE, WS2812::RGB(255, 255, 0)); // Yellow pulse
+        WaitForButtonPress(seconds * 1000, true);
         ClearLEDAndDisplay();
         server.clear_state();
     }
@@ -234,60 +362,44 @@ public:
         char positionMsg[50];
         snprintf(positionMsg, sizeof(positionMsg), "Changing position to %d", server.get_position());
 
-        const char *melodyName;
-        switch (server.get_melody())
+        const MelodyEntry &entry = findMelody(server.get_melody());
+        const char *melodyName = entry.name;
+        uint32_t duration_ms = entry.duration_ms;
+        Envelope envelope = entry.envelope;
+        const MelodySlot &uploaded = server.get_uploaded_melody();
+        bool playUploaded = server.get_melody() == 'U' && uploaded.length > 0;
+        if (playUploaded)
         {
-        case 'B':
-            melodyName = "Beep";
-            buzzer.playMelody(BeepMelody);
-            break;
-        case 'E':
-            melodyName = "Breeze";
-            buzzer.playMelody(BreezeMelody);
-            break;
-        case 'M':
-            melodyName = "Brrr";
-            buzzer.playMelody(RumbleMelody);
-            break;
-        case 'Z':
-            melodyName = "Bzzz";
-            buzzer.playMelody(BzzzMelody);
-            break;
-        case 'D':
-            melodyName = "DOOM";
-            buzzer.playMelody(DoomMelody);
-            break;
-        case 'R':
-            melodyName = "Rick Roll";
-            buzzer.playMelody(RickRollMelody);
-            break;
-        case 'N':
-            melodyName = "Nokia ringtone";
-            buzzer.playMelody(NokiaMelody);
-            break;
-        case 'K':
-            melodyName = "Krusty Krab";
-            buzzer.playMelody(KrabMelody);
-            break;
-        case 'P':
-            melodyName = "Pink Panther";
-            buzzer.playMelody(PinkPantherMelody);
-            break;
-        default:
-            melodyName = "None";
-            buzzer.playMelody(NoMelody);
-            break;
+            melodyName = uploaded.name[0] ? uploaded.name : "Uploaded";
+            duration_ms = melodyDuration(uploaded.melody());
+            envelope = FullEnvelope;
         }
 
+        // volume and fades of the request replace the ones of the melody, quiet mode caps the volume.
+        // Fades are opt-in, a melody with them is played note by note instead of streamed.
+        if (server.get_volume() >= 0)
+            envelope.volume = server.get_volume() * 255 / 100;
+        if (server.get_attack() >= 0)
+            envelope.attack_ms = server.get_attack();
+        if (server.get_release() >= 0)
+            envelope.release_ms = server.get_release();
+        if (server.is_quiet() && envelope.volume > BUZZER_QUIET_VOLUME)
+            envelope.volume = BUZZER_QUIET_VOLUME;
+        buzzer.setEnvelope(envelope);
+
+        if (playUploaded)
+            buzzer.playMelody(uploaded.melody());
+        else
+            buzzer.playMelody(entry.packed);
+
         char melodyMsg[50];
         snprintf(melodyMsg, sizeof(melodyMsg), "Playing: %s", melodyName);
 
         UpdateDisplay("Desk Alarm", positionMsg, melodyMsg, "Press button to dismiss");
-        ActivateLED(WS2812::RGB(0, 128, 0)); // Green
+        ActivateLED(WS2812Effects::CHASE, WS2812::RGB(0, 255, 0), 600); // Green chase
 
-        while (!buzzer.isDone())
-            if (buttonPressed())
-                break;
+        // the known melody length is counted down on screen, the alarm ends once the buzzer reports it is done
+        WaitForButtonPress(duration_ms, true, true);
         buzzer.stopMelody();
         ClearLEDAndDisplay();
         server.clear_state();
@@ -326,7 +438,8 @@ int main()
     // ssd1306 to set itself up
     sleep_ms(250);
 
-    Scheduler scheduler;
+    // static, it holds the uploaded melody slot and is too big for the stack
+    static Scheduler scheduler;
     scheduler.run();
     return 0;
 }
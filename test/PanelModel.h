@@ -0,0 +1,100 @@
+#ifndef HOST_PANEL_MODEL_H
+#define HOST_PANEL_MODEL_H
+
+#include <string.h>
+#include "sim.h"
+
+// Display RAM of a SSD1306 rebuilt from the recorded i2c traffic, horizontal addressing mode only
+class PanelModel {
+public:
+    uint8_t ram[1024];
+    bool scrolling = false;
+
+    explicit PanelModel(uint8_t address = 0x3C) : address(address) {
+        memset(ram, 0, sizeof(ram));
+    }
+
+    // Replays transactions recorded since the previous call
+    void update() {
+        const std::vector<sim::I2cWrite> &writes = sim::i2cWrites();
+        for (; seen < writes.size(); seen++) {
+            const sim::I2cWrite &write = writes[seen];
+            if (write.address != address || write.bytes.empty()) continue;
+            if (write.bytes[0] == 0x40) {
+                for (size_t i = 1; i < write.bytes.size(); i++) data(write.bytes[i]);
+            } else if (write.bytes[0] == 0x00) {
+                commands(write.bytes.data() + 1, write.bytes.size() - 1);
+            }
+        }
+    }
+
+    // Transactions are recorded from now on only, e.g. after sim::clearI2cWrites
+    void restart() {
+        seen = 0;
+    }
+
+private:
+    uint8_t address;
+    size_t seen = 0;
+    uint8_t pageStart = 0, pageEnd = 7, columnStart = 0, columnEnd = 127;
+    uint8_t page = 0, column = 0;
+
+    void data(uint8_t byte) {
+        ram[page * 128 + column] = byte;
+        if (column++ == columnEnd) {
+            column = columnStart;
+            page = page == pageEnd ? pageStart : page + 1;
+        }
+    }
+
+    void commands(const uint8_t *bytes, size_t count) {
+        size_t i = 0;
+        while (i < count) {
+            uint8_t command = bytes[i++];
+            switch (command) {
+                case 0x21:
+                    columnStart = column = bytes[i];
+                    columnEnd = bytes[i + 1];
+                    i += 2;
+                    break;
+                case 0x22:
+                    pageStart = page = bytes[i];
+                    pageEnd = bytes[i + 1];
+                    i += 2;
+                    break;
+                case 0x26:
+                case 0x27:
+                    i += 6;
+                    break;
+                case 0x29:
+                case 0x2A:
+                    i += 5;
+                    break;
+                case 0xA3:
+                    i += 2;
+                    break;
+                case 0x2E:
+                    scrolling = false;
+                    break;
+                case 0x2F:
+                    scrolling = true;
+                    break;
+                case 0x20:
+                case 0x81:
+                case 0x8D:
+                case 0xA8:
+                case 0xD3:
+                case 0xD5:
+                case 0xD9:
+                case 0xDA:
+                case 0xDB:
+                    i += 1;
+                    break;
+                default:
+                    break;
+            }
+        }
+    }
+};
+
+#endif
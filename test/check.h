@@ -0,0 +1,33 @@
+#ifndef HOST_CHECK_H
+#define HOST_CHECK_H
+
+#include <stdio.h>
+
+// Failed checks are printed and counted, a test returns checkResult() from main
+static int checkFailures = 0;
+
+#define CHECK(condition) \
+    do { \
+        if (!(condition)) { \
+            printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition); \
+            checkFailures++; \
+        } \
+    } while (0)
+
+#define CHECK_EQ(actual, expected) \
+    do { \
+        long long checkActual = (long long) (actual); \
+        long long checkExpected = (long long) (expected); \
+        if (checkActual != checkExpected) { \
+            printf("%s:%d: check failed: %s == %s, got %lld, expected %lld\n", __FILE__, __LINE__, \
+                   #actual, #expected, checkActual, checkExpected); \
+            checkFailures++; \
+        } \
+    } while (0)
+
+static inline int checkResult() {
+    if (checkFailures) printf("%d checks failed\n", checkFailures);
+    return checkFailures ? 1 : 0;
+}
+
+#endif
@@ -0,0 +1,102 @@
+// Random drawing on a 128x64 display, display RAM rebuilt from the i2c traffic has to match a per pixel model
+// after every flush, whichever way it was sent.
+
+#include <random>
+#include "check.h"
+#include "PanelModel.h"
+#include "ssd1306.h"
+
+using namespace pico_ssd1306;
+
+namespace {
+    bool pixels[64][128];
+
+    void apply(int x, int y, WriteMode mode) {
+        if (x < 0 || x >= 128 || y < 0 || y >= 64) return;
+        if (mode == WriteMode::ADD) pixels[y][x] = true;
+        if (mode == WriteMode::SUBTRACT) pixels[y][x] = false;
+        if (mode == WriteMode::INVERT) pixels[y][x] = !pixels[y][x];
+    }
+
+    bool matches(const PanelModel &panel) {
+        for (int y = 0; y < 64; y++) {
+            for (int x = 0; x < 128; x++) {
+                bool lit = panel.ram[(y / 8) * 128 + x] >> (y & 7) & 1;
+                if (lit != pixels[y][x]) return false;
+            }
+        }
+        return true;
+    }
+}
+
+int main() {
+    SSD1306 display(i2c0, 0x3C, Size::W128xH64);
+    PanelModel panel;
+    panel.update();
+    CHECK(matches(panel));
+
+    std::mt19937 random(7);
+    auto between = [&](int low, int high) { return std::uniform_int_distribution<int>(low, high)(random); };
+
+    for (int frame = 0; frame < 300; frame++) {
+        for (int draw = between(1, 6); draw > 0; draw--) {
+            WriteMode mode = (WriteMode) between(0, 2);
+            int x = between(-10, 130), y = between(-10, 70);
+
+            switch (between(0, 3)) {
+                case 0: {
+                    int x1 = x + between(-5, 60), y1 = y + between(-5, 40);
+                    display.fillArea(x, y, x1, y1, mode);
+                    for (int py = y < 0 ? 0 : y; py <= y1; py++) {
+                        for (int px = x < 0 ? 0 : x; px <= x1; px++) apply(px, py, mode);
+                    }
+                    break;
+                }
+                case 1: {
+                    uint32_t bits = random();
+                    uint8_t count = between(0, 32);
+                    display.setColumn(x, y, bits, count, mode);
+                    for (int i = 0; i < count; i++) {
+                        if (bits >> i & 1) apply(x, y + i, mode);
+                    }
+                    break;
+                }
+                case 2: {
+                    uint8_t bytes[40];
+                    uint8_t count = between(1, 40);
+                    for (int i = 0; i < count; i++) bytes[i] = random();
+                    display.setPageBytes(x, y, bytes, count, mode);
+                    for (int i = 0; i < count; i++) {
+                        for (int bit = 0; bit < 8; bit++) {
+                            if (bytes[i] >> bit & 1) apply(x + i, y + bit, mode);
+                        }
+                    }
+                    break;
+                }
+                default: {
+                    uint8_t bytes[40];
+                    uint8_t count = between(1, 40);
+                    for (int i = 0; i < count; i++) bytes[i] = random();
+                    display.copyPageBytes(x, y, bytes, count);
+                    for (int i = 0; i < count; i++) {
+                        for (int bit = 0; bit < 8; bit++) {
+                            apply(x + i, y + bit, bytes[i] >> bit & 1 ? WriteMode::ADD : WriteMode::SUBTRACT);
+                        }
+                    }
+                    break;
+                }
+            }
+        }
+
+        if (frame % 2) {
+            display.sendBuffer();
+        } else {
+            display.sendBufferAsync();
+            display.waitForSend();
+        }
+        panel.update();
+        CHECK(matches(panel));
+    }
+
+    return checkResult();
+}
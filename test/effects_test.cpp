@@ -0,0 +1,135 @@
+// Frames of every effect at given times, first straight from pixelColor and then as sent by the timer driven
+// engine while the virtual clock runs.
+
+#include "check.h"
+#include "sim.h"
+#include "WS2812.hpp"
+#include "WS2812Effects.hpp"
+
+namespace {
+    const uint32_t orange = WS2812::RGB(0xFF, 0x80, 0x40);
+
+    uint32_t color(WS2812Effects::Effect effect, uint32_t t_ms, uint index = 0, uint period_ms = 1000, uint length = 10) {
+        return WS2812Effects::pixelColor(effect, orange, period_ms, index, length, t_ms);
+    }
+
+    // Words of the last frame that went out on whichever state machine the strip claimed
+    const uint32_t *lastFrame(uint length) {
+        for (unsigned sm = 0; sm < 4; sm++) {
+            const std::vector<uint32_t> &words = sim::pioWords(0, sm);
+            if (words.size() >= length) return words.data() + words.size() - length;
+        }
+        return nullptr;
+    }
+
+    size_t sentWords() {
+        size_t count = 0;
+        for (unsigned sm = 0; sm < 4; sm++) count += sim::pioWords(0, sm).size();
+        return count;
+    }
+}
+
+int main() {
+    // SOLID never changes
+    CHECK_EQ(color(WS2812Effects::SOLID, 0), orange);
+    CHECK_EQ(color(WS2812Effects::SOLID, 12345, 7), orange);
+    CHECK_EQ(color(WS2812Effects::OFF, 500), 0u);
+
+    // PULSE is a triangle, dark at the start of a period and full in the middle
+    CHECK_EQ(color(WS2812Effects::PULSE, 0), 0u);
+    CHECK_EQ(color(WS2812Effects::PULSE, 250), WS2812::RGB(0x7F, 0x40, 0x20));
+    CHECK_EQ(color(WS2812Effects::PULSE, 500), orange);
+    CHECK_EQ(color(WS2812Effects::PULSE, 750), WS2812::RGB(0x7F, 0x40, 0x20));
+    CHECK_EQ(color(WS2812Effects::PULSE, 1000), 0u);
+    CHECK_EQ(color(WS2812Effects::PULSE, 250, 9), color(WS2812Effects::PULSE, 250, 0));
+
+    // CHASE: head in full color, the pixel behind it at 64 / 256, wrapping around the end
+    const uint32_t tail = WS2812::RGB(0x3F, 0x20, 0x10);
+    CHECK_EQ(color(WS2812Effects::CHASE, 0, 0), orange);
+    CHECK_EQ(color(WS2812Effects::CHASE, 0, 9), tail);
+    CHECK_EQ(color(WS2812Effects::CHASE, 0, 1), 0u);
+    CHECK_EQ(color(WS2812Effects::CHASE, 350, 3), orange);
+    CHECK_EQ(color(WS2812Effects::CHASE, 350, 2), tail);
+    CHECK_EQ(color(WS2812Effects::CHASE, 350, 4), 0u);
+    CHECK_EQ(color(WS2812Effects::CHASE, 1950, 9), orange);
+    CHECK_EQ(color(WS2812Effects::CHASE, 1950, 8), tail);
+    CHECK_EQ(color(WS2812Effects::CHASE, 0, 0, 1000, 0), 0u);
+
+    // RAINBOW ignores color, a third of the strip or of the period is a third of the wheel
+    CHECK_EQ(color(WS2812Effects::RAINBOW, 0, 0, 900, 3), WS2812::RGB(255, 0, 0));
+    CHECK_EQ(color(WS2812Effects::RAINBOW, 0, 1, 900, 3), WS2812::RGB(0, 255, 0));
+    CHECK_EQ(color(WS2812Effects::RAINBOW, 0, 2, 900, 3), WS2812::RGB(0, 0, 255));
+    CHECK_EQ(color(WS2812Effects::RAINBOW, 300, 0, 900, 3), WS2812::RGB(0, 255, 0));
+    CHECK_EQ(color(WS2812Effects::RAINBOW, 300, 2, 900, 3), WS2812::RGB(255, 0, 0));
+    for (uint index = 0; index < 8; index++) {
+        // rotated by one pixel every period / length
+        CHECK_EQ(color(WS2812Effects::RAINBOW, 100, index, 800, 8), color(WS2812Effects::RAINBOW, 0, (index + 1) % 8, 800, 8));
+    }
+
+    // BLINK is on for the first half of the period
+    CHECK_EQ(color(WS2812Effects::BLINK, 0), orange);
+    CHECK_EQ(color(WS2812Effects::BLINK, 499), orange);
+    CHECK_EQ(color(WS2812Effects::BLINK, 500), 0u);
+    CHECK_EQ(color(WS2812Effects::BLINK, 999), 0u);
+    CHECK_EQ(color(WS2812Effects::BLINK, 1000), orange);
+
+    // Engine, frames every 20 ms from the timer, without gamma so that sent words are the colors packed
+    BasicWS2812<8> strip(2, pio0);
+    strip.setGammaCorrection(false);
+    BasicWS2812Effects<decltype(strip)> effects(strip);
+
+    const uint32_t red = decltype(strip)::pack(WS2812::RGB(255, 0, 0));
+    const uint32_t blue = WS2812::RGB(0, 0, 255);
+
+    // first frame goes out from start() itself
+    effects.start(WS2812Effects::BLINK, WS2812::RGB(255, 0, 0), 200);
+    CHECK_EQ(sentWords(), 8u);
+    CHECK_EQ(lastFrame(8)[0], red);
+
+    // equal frames are not sent again, first dark one is due at 100 ms
+    sim::advance(99000);
+    CHECK_EQ(sentWords(), 8u);
+    sim::advance(1000);
+    CHECK_EQ(sentWords(), 16u);
+    CHECK_EQ(lastFrame(8)[7], 0u);
+    sim::advance(100000);
+    CHECK_EQ(sentWords(), 24u);
+    CHECK_EQ(lastFrame(8)[7], red);
+
+    // PULSE a quarter period in is at half level, frames only come at multiples of 20 ms
+    sim::clearPioWords();
+    effects.start(WS2812Effects::PULSE, blue, 800);
+    CHECK_EQ(lastFrame(8)[0], 0u);
+    sim::advance(200000);
+    for (uint i = 0; i < 8; i++) CHECK_EQ(lastFrame(8)[i], decltype(strip)::pack(WS2812::RGB(0, 0, 0x7F)));
+
+    // CHASE of 8 pixels over 800 ms moves on every 100 ms
+    effects.start(WS2812Effects::CHASE, blue, 800);
+    sim::advance(340000);
+    const uint32_t *frame = lastFrame(8);
+    CHECK_EQ(frame[3], decltype(strip)::pack(blue));
+    CHECK_EQ(frame[2], decltype(strip)::pack(WS2812::RGB(0, 0, 0x3F)));
+    CHECK_EQ(frame[4], 0u);
+    CHECK_EQ(frame[1], 0u);
+
+    // RAINBOW a third of the period in
+    effects.start(WS2812Effects::RAINBOW, 0, 600);
+    sim::advance(200000);
+    frame = lastFrame(8);
+    for (uint i = 0; i < 8; i++) {
+        CHECK_EQ(frame[i], decltype(strip)::pack(WS2812Effects::pixelColor(WS2812Effects::RAINBOW, 0, 600, i, 8, 200)));
+    }
+    CHECK_EQ(frame[0], decltype(strip)::pack(WS2812::RGB(0, 255, 0)));
+
+    // SOLID is sent once and not animated, stop() turns everything off
+    sim::clearPioWords();
+    effects.start(WS2812Effects::SOLID, blue);
+    sim::advance(500000);
+    CHECK_EQ(sentWords(), 8u);
+    effects.stop();
+    CHECK_EQ(sentWords(), 16u);
+    for (uint i = 0; i < 8; i++) CHECK_EQ(lastFrame(8)[i], 0u);
+    CHECK_EQ(effects.getEffect(), WS2812Effects::OFF);
+
+    return checkResult();
+}
@@ -0,0 +1,119 @@
+// Bytes a flush puts on the bus, for single pixel changes and for the screens the scheduler shows.
+// Only changed windows may be sent and an unchanged frame has to cost nothing.
+
+#include <stdio.h>
+#include <initializer_list>
+#include "check.h"
+#include "sim.h"
+#include "ssd1306.h"
+#include "compositor/Screen.h"
+#include "compositor/Widgets.h"
+
+using namespace pico_ssd1306;
+
+namespace {
+    constexpr auto clockFont = makePageFont<font_16x32>("0123456789:");
+    constexpr auto titleFont = makePageFont<font_12x16>(" .-ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz");
+    constexpr auto textFont = makePageFont<font_5x8>(" !\"#$%&'()*+,-./0123456789:;<=>?@ABCDEFGHIJKLMNOPQRSTUVWXYZ[\\]^_`abcdefghijklmnopqrstuvwxyz{|}~");
+
+    // Number of data transactions, every window sent is one
+    size_t windows() {
+        size_t count = 0;
+        for (auto &write : sim::i2cWrites()) {
+            if (!write.bytes.empty() && write.bytes[0] == 0x40) count++;
+        }
+        return count;
+    }
+
+    // Flushes display one way or the other and returns bytes it took on the bus
+    size_t flush(SSD1306 &display, bool async) {
+        sim::clearI2cWrites();
+        if (async) {
+            display.sendBufferAsync();
+            display.waitForSend();
+        } else {
+            display.sendBuffer();
+        }
+        return sim::i2cBytes();
+    }
+}
+
+int main() {
+    SSD1306 display(i2c0, 0x3C, Size::W128xH64);
+
+    for (bool async : {false, true}) {
+        // nothing changed
+        CHECK_EQ(flush(display, async), 0u);
+
+        // single pixel is one window of one byte
+        display.setPixel(70, 21);
+        size_t bytes = flush(display, async);
+        CHECK_EQ(windows(), 1u);
+        CHECK(bytes <= 7u + 2u);
+        CHECK_EQ(flush(display, async), 0u);
+
+        display.setPixel(70, 21, WriteMode::SUBTRACT);
+        flush(display, async);
+        CHECK_EQ(windows(), 1u);
+    }
+
+    // Idle screen, laid out like Scheduler does it
+    Screen idleScreen(&display);
+    BigClock<decltype(clockFont)> idleClock(clockFont, 24, 16);
+    Label<decltype(textFont)> idleFooter(textFont, 46, 56, 7, "Group 7");
+    idleScreen.add(idleClock);
+    idleScreen.add(idleFooter);
+
+    display.clear();
+    idleScreen.render();
+    idleClock.setTime(12, 34);
+    idleScreen.render();
+    size_t first = flush(display, true);
+    printf("idle screen first frame: %zu bytes\n", first);
+
+    // tick within the same minute
+    idleClock.setTime(12, 34, 56);
+    idleScreen.render();
+    CHECK_EQ(flush(display, true), 0u);
+
+    // one digit changes, its 16x32 tile is at most 4 pages of 16 columns
+    idleClock.setTime(12, 35);
+    idleScreen.render();
+    size_t minute = flush(display, true);
+    printf("idle screen minute change: %zu bytes in %zu windows\n", minute, windows());
+    CHECK(minute > 0);
+    CHECK(minute <= 4 * (7 + 17));
+
+    // Message screen
+    Screen messageScreen(&display);
+    Label<decltype(titleFont)> messageTitle(titleFont, 0, 0, 11);
+    Label<decltype(textFont)> messageLines[4] = {{textFont, 0, 16, 25}, {textFont, 0, 26, 25},
+                                                 {textFont, 0, 36, 25}, {textFont, 0, 46, 25}};
+    Label<decltype(textFont)> messageFooter(textFont, 46, 56, 7, "Group 7");
+    messageScreen.add(messageTitle);
+    for (auto &line : messageLines) messageScreen.add(line);
+    messageScreen.add(messageFooter);
+
+    display.clear();
+    messageScreen.invalidate();
+    messageTitle.setText("Meeting");
+    messageLines[0].setText("Room 4.12");
+    messageScreen.render();
+    first = flush(display, true);
+    printf("message screen first frame: %zu bytes\n", first);
+    CHECK(first <= 8 * (7 + 129));
+
+    messageTitle.setText("Meeting");
+    messageScreen.render();
+    CHECK_EQ(flush(display, true), 0u);
+
+    // changing one line leaves title and footer alone
+    messageLines[0].setText("Room 4.13");
+    messageScreen.render();
+    size_t line = flush(display, true);
+    printf("message screen line change: %zu bytes in %zu windows\n", line, windows());
+    CHECK(line > 0);
+    CHECK(line <= 2 * (7 + 129));
+
+    return checkResult();
+}
@@ -0,0 +1,115 @@
+// drawChar puts glyph columns into the frame buffer a byte at a time, it has to draw exactly what going pixel by
+// pixel draws, for every font, write mode, rotation and page offset. Both are timed for comparison.
+
+#include <chrono>
+#include <stdio.h>
+#include "check.h"
+#include "PanelModel.h"
+#include "ssd1306.h"
+#include "textRenderer/TextRenderer.h"
+
+using namespace pico_ssd1306;
+
+namespace {
+    // drawChar as it was before the column path, one setPixel per glyph bit
+    void drawCharPixels(SSD1306 *ssd1306, const unsigned char *font, char c, uint8_t anchor_x, uint8_t anchor_y,
+                        WriteMode mode, Rotation rotation) {
+        if (c < 32) return;
+
+        uint8_t font_width = font[0];
+        uint8_t font_height = font[1];
+        uint16_t seek = (c - 32) * (font_width * font_height) / 8 + 2;
+        uint8_t b_seek = 0;
+
+        for (uint8_t x = 0; x < font_width; x++) {
+            for (uint8_t y = 0; y < font_height; y++) {
+                if (font[seek] >> b_seek & 1) {
+                    if (rotation == Rotation::deg0) {
+                        ssd1306->setPixel(x + anchor_x, y + anchor_y, mode);
+                    } else {
+                        ssd1306->setPixel(-y + anchor_x + font_height, x + anchor_y, mode);
+                    }
+                }
+                if (++b_seek == 8) {
+                    b_seek = 0;
+                    seek++;
+                }
+            }
+        }
+    }
+
+    // same background on both displays, so that SUBTRACT and INVERT have something to work on
+    void background(SSD1306 &display) {
+        display.clear();
+        for (int x = 0; x < 128; x += 3) display.fillArea(x, 0, x, 63);
+        display.fillArea(0, 20, 127, 30, WriteMode::INVERT);
+    }
+
+    double microseconds(std::chrono::steady_clock::duration duration) {
+        return std::chrono::duration<double, std::micro>(duration).count();
+    }
+}
+
+int main() {
+    SSD1306 fast(i2c0, 0x3C, Size::W128xH64);
+    SSD1306 reference(i2c0, 0x3D, Size::W128xH64);
+    PanelModel fastPanel(0x3C), referencePanel(0x3D);
+
+    const unsigned char *fonts[] = {font_5x8, font_8x8, font_12x16, font_16x32};
+    const WriteMode modes[] = {WriteMode::ADD, WriteMode::SUBTRACT, WriteMode::INVERT};
+    const Rotation rotations[] = {Rotation::deg0, Rotation::deg90};
+
+    for (const unsigned char *font : fonts) {
+        for (WriteMode mode : modes) {
+            for (Rotation rotation : rotations) {
+                // every page offset, the last ones run over the bottom edge
+                for (uint8_t y = 0; y < 8; y++) {
+                    background(fast);
+                    background(reference);
+
+                    uint8_t x = 0;
+                    for (char c = '!'; c <= '~' && x < 128; c += 7, x += font[0] + 1) {
+                        uint8_t anchor_y = y + (rotation == Rotation::deg0 ? 30 : 0);
+                        drawChar(&fast, font, c, x, anchor_y, mode, rotation);
+                        drawCharPixels(&reference, font, c, x, anchor_y, mode, rotation);
+                    }
+
+                    fast.sendBuffer();
+                    reference.sendBuffer();
+                    fastPanel.update();
+                    referencePanel.update();
+                    CHECK(memcmp(fastPanel.ram, referencePanel.ram, sizeof(fastPanel.ram)) == 0);
+                }
+            }
+        }
+    }
+
+    // idle clock: five 16x32 digits at an offset that is not page aligned
+    const int rounds = 2000;
+    const char *clock = "12:34";
+
+    auto start = std::chrono::steady_clock::now();
+    for (int round = 0; round < rounds; round++) {
+        for (int n = 0; n < 5; n++) drawChar(&fast, font_16x32, clock[n], 24 + n * 16, 17, WriteMode::INVERT);
+    }
+    double columns = microseconds(std::chrono::steady_clock::now() - start);
+
+    start = std::chrono::steady_clock::now();
+    for (int round = 0; round < rounds; round++) {
+        for (int n = 0; n < 5; n++) {
+            drawCharPixels(&reference, font_16x32, clock[n], 24 + n * 16, 17, WriteMode::INVERT, Rotation::deg0);
+        }
+    }
+    double pixels = microseconds(std::chrono::steady_clock::now() - start);
+
+    printf("16x32 clock, per frame: columns %.2f us, pixels %.2f us, %.1fx\n",
+           columns / rounds, pixels / rounds, pixels / columns);
+
+    fast.sendBuffer();
+    reference.sendBuffer();
+    fastPanel.update();
+    referencePanel.update();
+    CHECK(memcmp(fastPanel.ram, referencePanel.ram, sizeof(fastPanel.ram)) == 0);
+
+    return checkResult();
+}
@@ -0,0 +1,75 @@
+// Throughput of setPixel, fillArea and drawText for both display sizes, through SSD1306 and straight through the
+// PanelCanvas of the size. Both ways have to draw the same frame.
+
+#include <chrono>
+#include <random>
+#include <stdio.h>
+#include <string.h>
+#include "check.h"
+#include "ssd1306.h"
+#include "textRenderer/TextRenderer.h"
+
+using namespace pico_ssd1306;
+
+namespace {
+    template<typename Draw>
+    double nanoseconds(int rounds, Draw draw) {
+        auto start = std::chrono::steady_clock::now();
+        for (int round = 0; round < rounds; round++) draw(round);
+        auto duration = std::chrono::steady_clock::now() - start;
+        return std::chrono::duration<double, std::nano>(duration).count() / rounds;
+    }
+
+    template<Size S>
+    void run(const char *name) {
+        SSD1306 display(i2c0, 0x3C, S);
+        FrameBuffer frameBuffer;
+        frameBuffer.clear();
+        typedef PanelCanvas<S> Canvas;
+
+        // same random drawing both ways
+        std::mt19937 random(11);
+        for (int i = 0; i < 2000; i++) {
+            int16_t x = random() % 140 - 6, y = random() % 80 - 8;
+            WriteMode mode = (WriteMode) (random() % 3);
+            if (i % 4) {
+                display.setPixel(x, y, mode);
+                Canvas::setPixel(frameBuffer, x, y, mode);
+            } else {
+                int16_t x1 = x + random() % 40, y1 = y + random() % 30;
+                display.fillArea(x, y, x1, y1, mode);
+                Canvas::fillArea(frameBuffer, x, y, x1, y1, mode);
+            }
+        }
+        unsigned char drawn[FRAMEBUFFER_SIZE];
+        display.copyBuffer(drawn);
+        CHECK(memcmp(drawn, frameBuffer.get(), FRAMEBUFFER_SIZE) == 0);
+
+        const int rounds = 200000;
+        double pixelDisplay = nanoseconds(rounds, [&](int round) {
+            display.setPixel(round & 127, (round >> 7) & 63, WriteMode::INVERT);
+        });
+        double pixelCanvas = nanoseconds(rounds, [&](int round) {
+            Canvas::setPixel(frameBuffer, round & 127, (round >> 7) & 63, WriteMode::INVERT);
+        });
+        double fillDisplay = nanoseconds(rounds / 10, [&](int round) {
+            display.fillArea(round & 63, 3, (round & 63) + 40, 27, WriteMode::INVERT);
+        });
+        double fillCanvas = nanoseconds(rounds / 10, [&](int round) {
+            Canvas::fillArea(frameBuffer, round & 63, 3, (round & 63) + 40, 27, WriteMode::INVERT);
+        });
+        double text = nanoseconds(rounds / 100, [&](int round) {
+            drawText(&display, font_8x8, "12:34 Group 7", 0, round & 15, WriteMode::INVERT);
+        });
+
+        printf("%s setPixel: display %.1f ns, canvas %.1f ns\n", name, pixelDisplay, pixelCanvas);
+        printf("%s fillArea 41x25: display %.1f ns, canvas %.1f ns\n", name, fillDisplay, fillCanvas);
+        printf("%s drawText 13 chars 8x8: %.1f ns\n", name, text);
+    }
+}
+
+int main() {
+    run<Size::W128xH64>("128x64");
+    run<Size::W128xH32>("128x32");
+    return checkResult();
+}
@@ -0,0 +1,107 @@
+// Screen with static widgets in a background layer has to look exactly like the same screen drawing everything,
+// while static widgets are only rasterized when they change.
+
+#include <random>
+#include <string.h>
+#include "check.h"
+#include "PanelModel.h"
+#include "ssd1306.h"
+#include "compositor/Screen.h"
+#include "compositor/Widgets.h"
+
+using namespace pico_ssd1306;
+
+namespace {
+    constexpr auto titleFont = makePageFont<font_12x16>(" ABCDEFGHIJKLMNOPQRSTUVWXYZ");
+    constexpr auto textFont = makePageFont<font_5x8>(" 0123456789:ABCDEFGHIJKLMNOPQRSTUVWXYZ");
+
+    // Label counting how often it is rasterized
+    class CountingLabel : public Label<decltype(textFont)> {
+    public:
+        mutable int renders = 0;
+
+        using Label::Label;
+
+        void render(SSD1306 *ssd1306) const override {
+            renders++;
+            Label::render(ssd1306);
+        }
+    };
+
+    // Same widgets on two displays, one screen keeps title and footer in its background layer
+    struct Setup {
+        SSD1306 display;
+        PanelModel panel;
+        Screen screen;
+        Label<decltype(titleFont)> title;
+        CountingLabel footer;
+        Label<decltype(textFont)> line;
+        ProgressBar bar;
+
+        Setup(uint8_t address, bool layered)
+                : display(i2c0, address, Size::W128xH64), panel(address), screen(&display),
+                  title(titleFont, 4, 0, 10, "TITLE"), footer(textFont, 40, 56, 8, "GROUP 7"),
+                  line(textFont, 0, 52, 25), bar(0, 30, 128, 12, 100) {
+            if (layered) {
+                screen.addStatic(title);
+                screen.addStatic(footer);
+            } else {
+                screen.add(title);
+                screen.add(footer);
+            }
+            // overlaps the footer, restoring its bounds has to bring the footer back
+            screen.add(line);
+            screen.add(bar);
+        }
+
+        void frame() {
+            screen.render();
+            display.sendBuffer();
+            panel.update();
+        }
+    };
+}
+
+int main() {
+    Setup plain(0x3C, false);
+    Setup layered(0x3D, true);
+
+    plain.frame();
+    layered.frame();
+    CHECK(memcmp(plain.panel.ram, layered.panel.ram, sizeof(plain.panel.ram)) == 0);
+    CHECK_EQ(layered.footer.renders, 1);
+
+    std::mt19937 random(3);
+    for (int frame = 0; frame < 200; frame++) {
+        char text[26];
+        snprintf(text, sizeof(text), "LINE %u", (unsigned) random() % 1000);
+        uint16_t value = random() % 101;
+        bool lineShown = random() % 4 != 0;
+        bool switchScreen = random() % 10 == 0;
+
+        for (Setup *setup : {&plain, &layered}) {
+            setup->line.setText(text);
+            setup->line.setVisible(lineShown);
+            setup->bar.setValue(value);
+            if (switchScreen) {
+                setup->display.clear();
+                setup->screen.invalidate();
+            }
+            setup->frame();
+        }
+        CHECK(memcmp(plain.panel.ram, layered.panel.ram, sizeof(plain.panel.ram)) == 0);
+    }
+
+    // background was restored, never drawn again
+    CHECK_EQ(layered.footer.renders, 1);
+
+    // changing a static widget renders the layer again
+    for (Setup *setup : {&plain, &layered}) {
+        setup->title.setText("OTHER");
+        setup->frame();
+    }
+    CHECK(memcmp(plain.panel.ram, layered.panel.ram, sizeof(plain.panel.ram)) == 0);
+    CHECK_EQ(layered.footer.renders, 2);
+
+    return checkResult();
+}
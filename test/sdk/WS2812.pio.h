@@ -0,0 +1,18 @@
+// Stand-in for the header pioasm generates from WS2812.pio, the state machine itself is not simulated
+
+#ifndef HOST_WS2812_PIO_H
+#define HOST_WS2812_PIO_H
+
+#include "hardware/pio.h"
+
+static const uint16_t ws2812_program_instructions[4] = {0};
+
+static const struct pio_program ws2812_program = {
+    ws2812_program_instructions,
+    4,
+    -1,
+};
+
+static inline void ws2812_program_init(PIO pio, uint sm, uint offset, uint pin, float freq, uint bits) {}
+
+#endif
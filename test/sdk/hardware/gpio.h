@@ -0,0 +1,24 @@
+#ifndef HOST_HARDWARE_GPIO_H
+#define HOST_HARDWARE_GPIO_H
+
+#include "pico/types.h"
+
+enum gpio_function {
+    GPIO_FUNC_I2C = 3,
+    GPIO_FUNC_PWM = 4,
+    GPIO_FUNC_PIO0 = 6,
+    GPIO_FUNC_PIO1 = 7,
+    GPIO_FUNC_NULL = 0x1f
+};
+
+#define GPIO_OUT 1
+#define GPIO_IN 0
+
+static inline void gpio_init(uint) {}
+static inline void gpio_set_function(uint, enum gpio_function) {}
+static inline void gpio_set_dir(uint, bool) {}
+static inline void gpio_pull_up(uint) {}
+static inline void gpio_put(uint, bool) {}
+static inline bool gpio_get(uint) { return false; }
+
+#endif
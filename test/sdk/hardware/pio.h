@@ -0,0 +1,50 @@
+#ifndef HOST_HARDWARE_PIO_H
+#define HOST_HARDWARE_PIO_H
+
+#include "pico/types.h"
+
+#define NUM_PIOS 2
+#define NUM_PIO_STATE_MACHINES 4
+
+typedef struct {
+    volatile uint32_t ctrl;
+    volatile uint32_t fstat;
+    volatile uint32_t txf[NUM_PIO_STATE_MACHINES];
+} pio_hw_t;
+typedef pio_hw_t *PIO;
+
+extern pio_hw_t pio0_hw_s;
+extern pio_hw_t pio1_hw_s;
+#define pio0 (&pio0_hw_s)
+#define pio1 (&pio1_hw_s)
+
+typedef struct pio_program {
+    const uint16_t *instructions;
+    uint8_t length;
+    int8_t origin;
+} pio_program_t;
+
+typedef struct {
+    uint32_t clkdiv;
+} pio_sm_config;
+
+static inline uint pio_get_index(PIO pio) {
+    return pio == pio1 ? 1 : 0;
+}
+
+static inline uint pio_get_dreq(PIO pio, uint sm, bool is_tx) {
+    return pio_get_index(pio) * 8 + sm + (is_tx ? 0 : 4);
+}
+
+// Programs are placed one after the other, panics when instruction memory is full
+uint pio_add_program(PIO pio, const pio_program_t *program);
+void pio_remove_program(PIO pio, const pio_program_t *program, uint loaded_offset);
+
+void pio_sm_claim(PIO pio, uint sm);
+int pio_claim_unused_sm(PIO pio, bool required);
+void pio_sm_unclaim(PIO pio, uint sm);
+
+static inline void pio_sm_set_enabled(PIO, uint, bool) {}
+static inline uint pio_sm_get_tx_fifo_level(PIO, uint) { return 0; }
+
+#endif
@@ -0,0 +1,10 @@
+#ifndef HOST_HARDWARE_TIMER_H
+#define HOST_HARDWARE_TIMER_H
+
+#include "pico/types.h"
+
+uint64_t time_us_64();
+uint32_t time_us_32();
+void busy_wait_us_32(uint32_t delay_us);
+
+#endif
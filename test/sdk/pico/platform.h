@@ -0,0 +1,23 @@
+#ifndef HOST_PICO_PLATFORM_H
+#define HOST_PICO_PLATFORM_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "pico/types.h"
+
+#define panic(...) (printf(__VA_ARGS__), printf("\n"), abort())
+
+#ifndef MIN
+#define MIN(a, b) ((b) > (a) ? (a) : (b))
+#endif
+#ifndef MAX
+#define MAX(a, b) ((a) > (b) ? (a) : (b))
+#endif
+
+#define count_of(a) (sizeof(a) / sizeof((a)[0]))
+#define __not_in_flash_func(f) f
+
+// Spin loops move the virtual clock, so whatever they wait for gets a chance to happen
+void tight_loop_contents();
+
+#endif
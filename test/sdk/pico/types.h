@@ -0,0 +1,14 @@
+#ifndef HOST_PICO_TYPES_H
+#define HOST_PICO_TYPES_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+typedef unsigned int uint;
+typedef uint64_t absolute_time_t;
+
+// every SDK header pulls the platform macros in through pico.h
+#include "pico/platform.h"
+
+#endif
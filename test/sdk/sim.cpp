@@ -0,0 +1,532 @@
+#include "sim.h"
+
+#include <algorithm>
+#include "pico/stdlib.h"
+#include "hardware/dma.h"
+#include "hardware/i2c.h"
+#include "hardware/irq.h"
+#include "hardware/pio.h"
+
+static i2c_hw_t i2c0_hw_s;
+static i2c_hw_t i2c1_hw_s;
+i2c_inst_t i2c0_inst = {&i2c0_hw_s, false};
+i2c_inst_t i2c1_inst = {&i2c1_hw_s, false};
+
+pio_hw_t pio0_hw_s;
+pio_hw_t pio1_hw_s;
+
+namespace {
+    struct Alarm {
+        alarm_id_t id;
+        uint64_t time;
+        alarm_callback_t callback;
+        void *userData;
+        // set for alarms driving a repeating timer
+        repeating_timer_t *timer;
+    };
+
+    struct Channel {
+        bool claimed;
+        bool irqEnabled;
+        bool irqStatus;
+        // transfer runs until this time, 0 when idle
+        uint64_t busyUntil;
+        dma_channel_config config;
+        volatile void *write;
+        const volatile void *read;
+        uint count;
+    };
+
+    struct Handler {
+        uint num;
+        irq_handler_t handler;
+    };
+
+    uint64_t clock;
+    // set while due work is handled, nested clock steps from callbacks only move time then
+    bool dispatching;
+
+    std::vector<Alarm> alarms;
+    alarm_id_t nextAlarmId = 1;
+    unsigned alarmCapacity = 16;
+
+    std::vector<Handler> handlers;
+    bool irqEnabled[32];
+
+    Channel channels[NUM_DMA_CHANNELS];
+
+    uint i2cBaudrate[NUM_I2CS] = {100000, 100000};
+    std::vector<sim::I2cWrite> writes;
+    bool nack;
+
+    std::vector<uint32_t> pioFifo[NUM_PIOS][NUM_PIO_STATE_MACHINES];
+    bool smClaimed[NUM_PIOS][NUM_PIO_STATE_MACHINES];
+    uint32_t instructionsUsed[NUM_PIOS];
+
+    // controller is idle with an empty FIFO until something is sent
+    struct I2cPowerOn {
+        I2cPowerOn() {
+            i2c0_hw_s.status = I2C_IC_STATUS_TFE_BITS;
+            i2c1_hw_s.status = I2C_IC_STATUS_TFE_BITS;
+        }
+    } i2cPowerOn;
+
+    i2c_inst_t *i2cOf(volatile void *address) {
+        if (address == &i2c0_hw_s.data_cmd) return i2c0;
+        if (address == &i2c1_hw_s.data_cmd) return i2c1;
+        return nullptr;
+    }
+
+    std::vector<uint32_t> *pioFifoOf(volatile void *address) {
+        for (uint pio = 0; pio < NUM_PIOS; pio++) {
+            pio_hw_t *hw = pio ? pio1 : pio0;
+            for (uint sm = 0; sm < NUM_PIO_STATE_MACHINES; sm++) {
+                if (address == &hw->txf[sm]) return &pioFifo[pio][sm];
+            }
+        }
+        return nullptr;
+    }
+
+    // 8 data bits and the acknowledge bit per byte
+    uint64_t i2cTime(i2c_inst_t *i2c, size_t bytes) {
+        return bytes * 9 * 1000000ull / i2cBaudrate[i2c_hw_index(i2c)];
+    }
+
+    uint32_t readWord(const volatile void *base, uint index, uint size) {
+        switch (size) {
+            case DMA_SIZE_8:
+                return ((const volatile uint8_t *) base)[index];
+            case DMA_SIZE_16:
+                return ((const volatile uint16_t *) base)[index];
+            default:
+                return ((const volatile uint32_t *) base)[index];
+        }
+    }
+
+    // IC_DATA_CMD words, STOP bit ends a transaction
+    uint64_t runI2cTransfer(i2c_inst_t *i2c, const Channel &channel) {
+        i2c_hw_t *hw = i2c_get_hw(i2c);
+        uint size = channel.config.ctrl & 3;
+
+        if (nack) {
+            // controller flushes its FIFO on the missing acknowledge
+            hw->raw_intr_stat |= I2C_IC_RAW_INTR_STAT_TX_ABRT_BITS;
+            hw->tx_abrt_source = I2C_IC_TX_ABRT_SOURCE_ABRT_7B_ADDR_NOACK_BITS;
+            return i2cTime(i2c, 1);
+        }
+
+        sim::I2cWrite current = {(uint8_t) hw->tar, {}};
+        for (uint i = 0; i < channel.count; i++) {
+            uint32_t word = readWord(channel.read, i, size);
+            current.bytes.push_back(word & 0xFF);
+            if (word & I2C_IC_DATA_CMD_STOP_BITS) {
+                writes.push_back(current);
+                current.bytes.clear();
+                hw->raw_intr_stat |= I2C_IC_RAW_INTR_STAT_STOP_DET_BITS;
+            }
+        }
+        if (!current.bytes.empty()) writes.push_back(current);
+        return i2cTime(i2c, channel.count + 1);
+    }
+
+    void startTransfer(uint index) {
+        Channel &channel = channels[index];
+        uint64_t duration = 0;
+
+        if (i2c_inst_t *i2c = i2cOf(channel.write)) {
+            duration = runI2cTransfer(i2c, channel);
+        } else if (std::vector<uint32_t> *fifo = pioFifoOf(channel.write)) {
+            for (uint i = 0; i < channel.count; i++) {
+                fifo->push_back(readWord(channel.read, i, channel.config.ctrl & 3));
+            }
+        }
+
+        // finishes with the next clock step at the earliest
+        channel.busyUntil = clock + (duration ? duration : 1);
+    }
+
+    void callHandlers(uint num) {
+        // handlers may remove themselves, so the list is copied first
+        std::vector<Handler> current = handlers;
+        for (const Handler &handler : current) {
+            if (handler.num == num) handler.handler();
+        }
+    }
+
+    void finishTransfers() {
+        for (Channel &channel : channels) {
+            if (channel.busyUntil && channel.busyUntil <= clock) {
+                channel.busyUntil = 0;
+                channel.irqStatus = true;
+            }
+        }
+    }
+
+    void raiseInterrupts() {
+        // a handler that does not clear its source would be called forever, give up after a while
+        for (int round = 0; round < 64; round++) {
+            bool raised = false;
+
+            bool dmaPending = false;
+            for (const Channel &channel : channels) {
+                if (channel.irqEnabled && channel.irqStatus) dmaPending = true;
+            }
+            if (dmaPending && irqEnabled[DMA_IRQ_0]) {
+                callHandlers(DMA_IRQ_0);
+                raised = true;
+            }
+
+            for (uint i = 0; i < NUM_I2CS; i++) {
+                i2c_hw_t *hw = i2c_get_hw(i ? i2c1 : i2c0);
+                hw->intr_stat = hw->raw_intr_stat & hw->intr_mask;
+                if (hw->intr_stat && irqEnabled[I2C0_IRQ + i]) {
+                    callHandlers(I2C0_IRQ + i);
+                    raised = true;
+                }
+            }
+
+            if (!raised) return;
+        }
+    }
+
+    void fireAlarm(Alarm alarm) {
+        if (alarm.timer) {
+            if (alarm.timer->callback(alarm.timer)) {
+                alarm.time += alarm.timer->delay_us < 0 ? -alarm.timer->delay_us : alarm.timer->delay_us;
+                alarms.push_back(alarm);
+            }
+            return;
+        }
+
+        int64_t again = alarm.callback(alarm.id, alarm.userData);
+        if (again > 0) {
+            alarm.time += again;
+            alarms.push_back(alarm);
+        } else if (again < 0) {
+            alarm.time = clock - again;
+            alarms.push_back(alarm);
+        }
+    }
+
+    void handleDue() {
+        finishTransfers();
+        raiseInterrupts();
+    }
+
+    uint64_t alarmTime(uint64_t us) {
+        // alarms in the past go off with the next clock step
+        return clock + (us ? us : 1);
+    }
+}
+
+namespace sim {
+    uint64_t now() {
+        return clock;
+    }
+
+    void advance(uint64_t us) {
+        uint64_t target = clock + us;
+        if (dispatching) {
+            clock = target;
+            return;
+        }
+
+        dispatching = true;
+        handleDue();
+        while (true) {
+            auto next = std::min_element(alarms.begin(), alarms.end(), [](const Alarm &a, const Alarm &b) {
+                return a.time < b.time || (a.time == b.time && a.id < b.id);
+            });
+            uint64_t transferEnd = UINT64_MAX;
+            for (const Channel &channel : channels) {
+                if (channel.busyUntil) transferEnd = std::min(transferEnd, channel.busyUntil);
+            }
+
+            uint64_t alarmEnd = next == alarms.end() ? UINT64_MAX : next->time;
+            uint64_t step = std::min(alarmEnd, transferEnd);
+            if (step > target) break;
+
+            clock = std::max(clock, step);
+            if (alarmEnd == step) {
+                Alarm alarm = *next;
+                alarms.erase(next);
+                fireAlarm(alarm);
+            }
+            handleDue();
+        }
+        clock = target;
+        handleDue();
+        dispatching = false;
+    }
+
+    const std::vector<I2cWrite> &i2cWrites() {
+        return writes;
+    }
+
+    void clearI2cWrites() {
+        writes.clear();
+    }
+
+    size_t i2cBytes() {
+        size_t bytes = 0;
+        for (const I2cWrite &write : writes) {
+            bytes += write.bytes.size();
+        }
+        return bytes;
+    }
+
+    void setI2cNack(bool enabled) {
+        nack = enabled;
+
+        // reading IC_CLR_TX_ABRT is not modelled, an abort left over from the missing display goes with it
+        if (!enabled) {
+            i2c0_hw_s.raw_intr_stat &= ~I2C_IC_RAW_INTR_STAT_TX_ABRT_BITS;
+            i2c1_hw_s.raw_intr_stat &= ~I2C_IC_RAW_INTR_STAT_TX_ABRT_BITS;
+        }
+    }
+
+    const std::vector<uint32_t> &pioWords(unsigned pio, unsigned sm) {
+        return pioFifo[pio][sm];
+    }
+
+    void clearPioWords() {
+        for (auto &fifos : pioFifo) {
+            for (auto &fifo : fifos) fifo.clear();
+        }
+    }
+
+    void setAlarmCapacity(unsigned capacity) {
+        alarmCapacity = capacity;
+    }
+
+    unsigned pendingAlarms() {
+        return alarms.size();
+    }
+}
+
+void tight_loop_contents() {
+    sim::advance(1);
+}
+
+uint64_t time_us_64() {
+    return clock;
+}
+
+uint32_t time_us_32() {
+    return (uint32_t) clock;
+}
+
+void busy_wait_us_32(uint32_t delay_us) {
+    sim::advance(delay_us);
+}
+
+absolute_time_t get_absolute_time() {
+    return clock;
+}
+
+uint32_t to_ms_since_boot(absolute_time_t t) {
+    return (uint32_t) (t / 1000);
+}
+
+absolute_time_t delayed_by_us(absolute_time_t t, uint64_t us) {
+    return t + us;
+}
+
+absolute_time_t delayed_by_ms(absolute_time_t t, uint32_t ms) {
+    return t + ms * 1000ull;
+}
+
+absolute_time_t make_timeout_time_us(uint64_t us) {
+    return clock + us;
+}
+
+absolute_time_t make_timeout_time_ms(uint32_t ms) {
+    return clock + ms * 1000ull;
+}
+
+int64_t absolute_time_diff_us(absolute_time_t from, absolute_time_t to) {
+    return (int64_t) (to - from);
+}
+
+bool time_reached(absolute_time_t t) {
+    return clock >= t;
+}
+
+void sleep_us(uint64_t us) {
+    sim::advance(us);
+}
+
+void sleep_ms(uint32_t ms) {
+    sim::advance(ms * 1000ull);
+}
+
+alarm_id_t add_alarm_in_us(uint64_t us, alarm_callback_t callback, void *user_data, bool fire_if_past) {
+    if (alarms.size() >= alarmCapacity) return -1;
+    alarms.push_back({nextAlarmId, alarmTime(us), callback, user_data, nullptr});
+    return nextAlarmId++;
+}
+
+alarm_id_t add_alarm_in_ms(uint32_t ms, alarm_callback_t callback, void *user_data, bool fire_if_past) {
+    return add_alarm_in_us(ms * 1000ull, callback, user_data, fire_if_past);
+}
+
+bool cancel_alarm(alarm_id_t id) {
+    auto alarm = std::find_if(alarms.begin(), alarms.end(), [id](const Alarm &a) { return a.id == id; });
+    if (alarm == alarms.end()) return false;
+    alarms.erase(alarm);
+    return true;
+}
+
+bool add_repeating_timer_us(int64_t delay_us, repeating_timer_callback_t callback, void *user_data, repeating_timer_t *out) {
+    if (alarms.size() >= alarmCapacity) return false;
+    out->delay_us = delay_us;
+    out->callback = callback;
+    out->user_data = user_data;
+    out->alarm_id = nextAlarmId++;
+    alarms.push_back({out->alarm_id, alarmTime(delay_us < 0 ? -delay_us : delay_us), nullptr, nullptr, out});
+    return true;
+}
+
+bool add_repeating_timer_ms(int32_t delay_ms, repeating_timer_callback_t callback, void *user_data, repeating_timer_t *out) {
+    return add_repeating_timer_us(delay_ms * 1000ll, callback, user_data, out);
+}
+
+bool cancel_repeating_timer(repeating_timer_t *timer) {
+    return cancel_alarm(timer->alarm_id);
+}
+
+void irq_add_shared_handler(uint num, irq_handler_t handler, uint8_t order_priority) {
+    handlers.push_back({num, handler});
+}
+
+void irq_remove_handler(uint num, irq_handler_t handler) {
+    handlers.erase(std::remove_if(handlers.begin(), handlers.end(), [=](const Handler &h) {
+        return h.num == num && h.handler == handler;
+    }), handlers.end());
+}
+
+void irq_set_enabled(uint num, bool enabled) {
+    irqEnabled[num] = enabled;
+}
+
+uint i2c_init(i2c_inst_t *i2c, uint baudrate) {
+    i2cBaudrate[i2c_hw_index(i2c)] = baudrate;
+    return baudrate;
+}
+
+int i2c_write_blocking(i2c_inst_t *i2c, uint8_t addr, const uint8_t *src, size_t len, bool nostop) {
+    // address byte goes out either way
+    sim::advance(i2cTime(i2c, nack ? 1 : len + 1));
+    if (nack) return PICO_ERROR_GENERIC;
+    writes.push_back({addr, std::vector<uint8_t>(src, src + len)});
+    return (int) len;
+}
+
+int dma_claim_unused_channel(bool required) {
+    for (uint i = 0; i < NUM_DMA_CHANNELS; i++) {
+        if (!channels[i].claimed) {
+            channels[i].claimed = true;
+            return i;
+        }
+    }
+    if (required) panic("No DMA channels are available");
+    return -1;
+}
+
+void dma_channel_unclaim(uint channel) {
+    channels[channel] = {};
+}
+
+dma_channel_config dma_channel_get_default_config(uint channel) {
+    return {DMA_SIZE_32};
+}
+
+void channel_config_set_transfer_data_size(dma_channel_config *c, enum dma_channel_transfer_size size) {
+    c->ctrl = (c->ctrl & ~3u) | size;
+}
+
+void channel_config_set_read_increment(dma_channel_config *c, bool incr) {}
+
+void channel_config_set_write_increment(dma_channel_config *c, bool incr) {}
+
+void channel_config_set_dreq(dma_channel_config *c, uint dreq) {}
+
+void dma_channel_configure(uint channel, const dma_channel_config *config, volatile void *write_addr,
+                           const volatile void *read_addr, uint transfer_count, bool trigger) {
+    Channel &c = channels[channel];
+    c.config = *config;
+    c.write = write_addr;
+    c.read = read_addr;
+    c.count = transfer_count;
+    if (trigger) startTransfer(channel);
+}
+
+void dma_channel_transfer_from_buffer_now(uint channel, const volatile void *read_addr, uint32_t transfer_count) {
+    Channel &c = channels[channel];
+    c.read = read_addr;
+    c.count = transfer_count;
+    startTransfer(channel);
+}
+
+bool dma_channel_is_busy(uint channel) {
+    return channels[channel].busyUntil != 0;
+}
+
+void dma_channel_wait_for_finish_blocking(uint channel) {
+    while (dma_channel_is_busy(channel)) tight_loop_contents();
+}
+
+void dma_channel_abort(uint channel) {
+    channels[channel].busyUntil = 0;
+    channels[channel].irqStatus = false;
+}
+
+void dma_channel_set_irq0_enabled(uint channel, bool enabled) {
+    channels[channel].irqEnabled = enabled;
+}
+
+bool dma_channel_get_irq0_status(uint channel) {
+    return channels[channel].irqEnabled && channels[channel].irqStatus;
+}
+
+void dma_channel_acknowledge_irq0(uint channel) {
+    channels[channel].irqStatus = false;
+}
+
+uint pio_add_program(PIO pio, const pio_program_t *program) {
+    uint32_t mask = (1u << program->length) - 1;
+    uint32_t &used = instructionsUsed[pio_get_index(pio)];
+    for (uint offset = 0; offset + program->length <= 32; offset++) {
+        if (!(used & mask << offset)) {
+            used |= mask << offset;
+            return offset;
+        }
+    }
+    panic("No program space");
+    return 0;
+}
+
+void pio_remove_program(PIO pio, const pio_program_t *program, uint loaded_offset) {
+    instructionsUsed[pio_get_index(pio)] &= ~(((1u << program->length) - 1) << loaded_offset);
+}
+
+void pio_sm_claim(PIO pio, uint sm) {
+    bool &claimed = smClaimed[pio_get_index(pio)][sm];
+    if (claimed) panic("PIO %u SM (mask %u) is already claimed", pio_get_index(pio), 1u << sm);
+    claimed = true;
+}
+
+int pio_claim_unused_sm(PIO pio, bool required) {
+    for (uint sm = 0; sm < NUM_PIO_STATE_MACHINES; sm++) {
+        if (!smClaimed[pio_get_index(pio)][sm]) {
+            smClaimed[pio_get_index(pio)][sm] = true;
+            return sm;
+        }
+    }
+    if (required) panic("No PIO state machines are available");
+    return -1;
+}
+
+void pio_sm_unclaim(PIO pio, uint sm) {
+    smClaimed[pio_get_index(pio)][sm] = false;
+}
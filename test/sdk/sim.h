@@ -0,0 +1,44 @@
+#ifndef HOST_SIM_H
+#define HOST_SIM_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+// Control side of the simulated SDK the host tests are built against.
+//
+// Time only moves when a test or the code under test lets it: advance(), sleep_ms(), busy_wait_us_32() and
+// tight_loop_contents() step the virtual clock, fire alarms and repeating timers that are due, finish DMA
+// transfers and raise DMA and I2C interrupts. Everything runs on the calling thread, so a run is repeatable.
+namespace sim {
+    // One i2c transaction, address byte is not part of bytes
+    struct I2cWrite {
+        uint8_t address;
+        std::vector<uint8_t> bytes;
+    };
+
+    uint64_t now();
+
+    // Moves virtual clock forward, handling everything that becomes due on the way
+    void advance(uint64_t us);
+
+    // Transactions sent through i2c_write_blocking and through DMA into IC_DATA_CMD, in order
+    const std::vector<I2cWrite> &i2cWrites();
+    void clearI2cWrites();
+
+    // Total bytes on the bus for the recorded transactions, control bytes included
+    size_t i2cBytes();
+
+    // With nack set no device answers, blocking writes fail and DMA transfers into IC_DATA_CMD end in TX_ABRT
+    void setI2cNack(bool nack);
+
+    // Words DMA fed into a PIO TX FIFO, in order
+    const std::vector<uint32_t> &pioWords(unsigned pio, unsigned sm);
+    void clearPioWords();
+
+    // Alarms that may be pending at once, add_alarm_in_us fails beyond that like a full alarm pool
+    void setAlarmCapacity(unsigned capacity);
+    unsigned pendingAlarms();
+}
+
+#endif
@@ -0,0 +1,94 @@
+// Display that does not acknowledge, e.g. unplugged: flushes have to end and report the failure, and once it
+// answers again the whole buffer has to be sent so that its RAM is right again.
+
+#include <initializer_list>
+#include "check.h"
+#include "sim.h"
+#include "PanelModel.h"
+#include "ssd1306.h"
+
+using namespace pico_ssd1306;
+
+namespace {
+    int callbacks = 0;
+
+    void countCallback(void *) {
+        callbacks++;
+    }
+
+    size_t dataBytes() {
+        size_t count = 0;
+        for (auto &write : sim::i2cWrites()) {
+            if (!write.bytes.empty() && write.bytes[0] == 0x40) count += write.bytes.size() - 1;
+        }
+        return count;
+    }
+
+    void flush(SSD1306 &display, bool async) {
+        if (async) {
+            display.sendBufferAsync();
+            display.waitForSend();
+        } else {
+            display.sendBuffer();
+        }
+    }
+}
+
+int main() {
+    SSD1306 display(i2c0, 0x3C, Size::W128xH64);
+    display.setSendCallback(countCallback);
+    PanelModel panel;
+
+    // sent normally, callback only comes once the transfer stopped
+    display.fillArea(0, 0, 127, 7);
+    display.sendBufferAsync();
+    CHECK(display.isSendBusy());
+    CHECK_EQ(callbacks, 0);
+    display.waitForSend();
+    CHECK_EQ(callbacks, 1);
+    CHECK(!display.lastSendFailed());
+    panel.update();
+    CHECK_EQ(panel.ram[5], 0xFF);
+
+    for (bool async : {false, true}) {
+        callbacks = 0;
+
+        sim::setI2cNack(true);
+        display.fillArea(0, 0, 127, 7, WriteMode::SUBTRACT);
+        display.fillArea(10, 20, 19, 27);
+        flush(display, async);
+        CHECK(!display.isSendBusy());
+        CHECK(display.lastSendFailed());
+        if (async) CHECK_EQ(callbacks, 1);
+
+        // nothing got through, next flush after the display is back has to send everything
+        sim::setI2cNack(false);
+        display.setPixel(100, 60);
+        sim::clearI2cWrites();
+        panel.restart();
+        flush(display, async);
+        CHECK(!display.lastSendFailed());
+        CHECK_EQ(dataBytes(), 1024u);
+        if (async) CHECK_EQ(callbacks, 2);
+
+        panel.update();
+        CHECK_EQ(panel.ram[5], 0x00);
+        CHECK_EQ(panel.ram[2 * 128 + 15], 0xF0);
+        CHECK_EQ(panel.ram[3 * 128 + 15], 0x0F);
+        CHECK_EQ(panel.ram[7 * 128 + 100], 0x10);
+
+        // back to sending changes only
+        display.setPixel(100, 60, WriteMode::SUBTRACT);
+        display.fillArea(0, 0, 127, 7);
+        display.fillArea(10, 20, 19, 27, WriteMode::SUBTRACT);
+        sim::clearI2cWrites();
+        panel.restart();
+        flush(display, async);
+        CHECK(dataBytes() < 1024u);
+        panel.update();
+        CHECK_EQ(panel.ram[5], 0xFF);
+        CHECK_EQ(panel.ram[2 * 128 + 15], 0x00);
+    }
+
+    return checkResult();
+}
@@ -0,0 +1,73 @@
+// show() takes the alarm that ends a frame before anything goes out. With the alarm pool full it has to fail
+// without sending, instead of leaving the strip busy or waiting the latch out in an interrupt.
+
+#include "check.h"
+#include "sim.h"
+#include "WS2812.hpp"
+
+namespace {
+    int callbacks = 0;
+
+    void countCallback(void *) {
+        callbacks++;
+    }
+
+    size_t sentWords() {
+        size_t count = 0;
+        for (unsigned sm = 0; sm < 4; sm++) count += sim::pioWords(0, sm).size();
+        return count;
+    }
+
+    // First word sent on whichever state machine the strip claimed
+    uint32_t firstWord() {
+        for (unsigned sm = 0; sm < 4; sm++) {
+            if (!sim::pioWords(0, sm).empty()) return sim::pioWords(0, sm)[0];
+        }
+        return 0;
+    }
+}
+
+int main() {
+    const uint length = 8;
+    // 24 bits per LED at 1.25 us each
+    const uint64_t frameTime = length * 24 * 5 / 4;
+
+    WS2812 strip(2, length, pio0, WS2812::FORMAT_GRB);
+    strip.setShowCallback(countCallback);
+
+    strip.fill(WS2812::RGB(255, 0, 0));
+    CHECK(strip.show());
+    CHECK(strip.isBusy());
+    CHECK_EQ(sim::pendingAlarms(), 1u);
+    sim::advance(frameTime + WS2812_LATCH_US - 1);
+    CHECK_EQ(sentWords(), (size_t) length);
+    CHECK(strip.isBusy());
+    CHECK_EQ(callbacks, 0);
+
+    // margin of one LED at most on top of the frame and the latch
+    sim::advance(24 * 5 / 4 + 1);
+    CHECK(!strip.isBusy());
+    CHECK_EQ(callbacks, 1);
+    CHECK_EQ(sim::pendingAlarms(), 0u);
+
+    // no alarm left, nothing goes out and the strip stays usable
+    sim::clearPioWords();
+    sim::setAlarmCapacity(0);
+    strip.fill(WS2812::RGB(0, 0, 255));
+    CHECK(!strip.show());
+    CHECK(!strip.isBusy());
+    sim::advance(1000);
+    CHECK_EQ(sentWords(), 0u);
+    CHECK_EQ(callbacks, 1);
+
+    // same frame goes out once an alarm is free again
+    sim::setAlarmCapacity(16);
+    CHECK(strip.show());
+    strip.waitForShow();
+    CHECK_EQ(sentWords(), (size_t) length);
+    // GRB, blue is the third byte
+    CHECK_EQ(firstWord(), 0x0000FF00u);
+    CHECK_EQ(callbacks, 2);
+
+    return checkResult();
+}